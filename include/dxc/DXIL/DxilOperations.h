@@ -181,6 +181,10 @@ private:
   std::unordered_map<const llvm::Function *, OpCodeClass> m_FunctionToOpClass;
   void UpdateCache(OpCodeClass opClass, llvm::Type *Ty, llvm::Function *F);
 
+  // Function attribute sets, indexed by the OpCodeProperty::FuncAttr kind.
+  llvm::AttributeSet m_OpFuncAttributes[llvm::Attribute::EndAttrKinds];
+  llvm::AttributeSet GetOpFuncAttributes(OpCode opCode);
+
 private:
   // Static properties.
   struct OpCodeProperty {
@@ -21,6 +21,14 @@ enum class ZlibResult {
   OutOfMemory = 2,
 };
 
+// Trade-off between compression speed and compressed size. Every level
+// produces a standard zlib stream, so decompression is the same for all.
+enum class ZlibCompressionLevel {
+  Fast = 0,
+  Default = 1,
+  Best = 2,
+};
+
 ZlibResult ZlibDecompress(IMalloc *pMalloc, const void *pCompressedBuffer,
                           size_t BufferSizeInBytes, void *pUncompressedBuffer,
                           size_t UncompressedBufferSize);
@@ -37,7 +45,9 @@ ZlibResult ZlibDecompress(IMalloc *pMalloc, const void *pCompressedBuffer,
 //
 typedef void *ZlibCallbackFn(void *pUserData, size_t RequiredSize);
 
-ZlibResult ZlibCompress(IMalloc *pMalloc, const void *pData, size_t pDataSize,
-                        void *pUserData, ZlibCallbackFn *Callback,
-                        size_t *pOutCompressedSize);
+ZlibResult
+ZlibCompress(IMalloc *pMalloc, const void *pData, size_t pDataSize,
+             void *pUserData, ZlibCallbackFn *Callback,
+             size_t *pOutCompressedSize,
+             ZlibCompressionLevel Level = ZlibCompressionLevel::Default);
 } // namespace hlsl
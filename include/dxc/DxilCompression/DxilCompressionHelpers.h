@@ -22,8 +22,9 @@
 namespace hlsl {
 
 template <typename Buffer>
-ZlibResult ZlibCompressAppend(IMalloc *pMalloc, const void *pData,
-                              size_t dataSize, Buffer &outBuffer) {
+ZlibResult ZlibCompressAppend(
+    IMalloc *pMalloc, const void *pData, size_t dataSize, Buffer &outBuffer,
+    ZlibCompressionLevel level = ZlibCompressionLevel::Default) {
   static_assert(sizeof(typename Buffer::value_type) == sizeof(uint8_t),
                 "Cannot append to a non-byte-sized buffer.");
 
@@ -58,7 +59,7 @@ ZlibResult ZlibCompressAppend(IMalloc *pMalloc, const void *pData,
         void *ptr = pBuffer->data() + lastSize;
         return ptr;
       },
-      &compressedDataSize);
+      &compressedDataSize, level);
 
   if (ret == ZlibResult::Success) {
     // Resize the buffer to what was actually added to the end.
@@ -71,16 +72,14 @@ ZlibResult ZlibCompressAppend(IMalloc *pMalloc, const void *pData,
 
 template ZlibResult ZlibCompressAppend<llvm::SmallVectorImpl<char>>(
     IMalloc *pMalloc, const void *pData, size_t dataSize,
-    llvm::SmallVectorImpl<char> &outBuffer);
+    llvm::SmallVectorImpl<char> &outBuffer, ZlibCompressionLevel level);
 template ZlibResult ZlibCompressAppend<llvm::SmallVectorImpl<uint8_t>>(
     IMalloc *pMalloc, const void *pData, size_t dataSize,
-    llvm::SmallVectorImpl<uint8_t> &outBuffer);
-template ZlibResult
-ZlibCompressAppend<std::vector<char>>(IMalloc *pMalloc, const void *pData,
-                                      size_t dataSize,
-                                      std::vector<char> &outBuffer);
-template ZlibResult
-ZlibCompressAppend<std::vector<uint8_t>>(IMalloc *pMalloc, const void *pData,
-                                         size_t dataSize,
-                                         std::vector<uint8_t> &outBuffer);
+    llvm::SmallVectorImpl<uint8_t> &outBuffer, ZlibCompressionLevel level);
+template ZlibResult ZlibCompressAppend<std::vector<char>>(
+    IMalloc *pMalloc, const void *pData, size_t dataSize,
+    std::vector<char> &outBuffer, ZlibCompressionLevel level);
+template ZlibResult ZlibCompressAppend<std::vector<uint8_t>>(
+    IMalloc *pMalloc, const void *pData, size_t dataSize,
+    std::vector<uint8_t> &outBuffer, ZlibCompressionLevel level);
 } // namespace hlsl
@@ -40,6 +40,8 @@ enum class DxilShaderHashFlags : uint32_t {
   None = 0,           // No flags defined.
   IncludesSource = 1, // This flag indicates that the shader hash was computed
                       // taking into account source information (-Zss)
+  XXHash64 = 2,       // The digest is a zero-extended xxHash64 value instead
+                      // of MD5 (-Qfast_shader_hash)
 };
 
 typedef struct DxilShaderHash {
@@ -306,6 +308,19 @@ struct DxilCompilerVersion {
 //      char ArgName[]; char NullTerm;
 //      char ArgValue[]; char NullTerm;
 //
+// ================ 4. Source Store Keys ==================================
+//
+//  DxilSourceInfo_SourceStoreKeys
+//    uint8_t Digest[16]
+//    uint8_t Digest[16]
+//    ...
+//    uint8_t Digest[16]
+//
+// Written with -Qsource_store instead of the Source Contents section. The
+// contents are kept in an external source store, in files named by the hex
+// digest. Readers that predate this section skip it and see the sources with
+// no contents.
+//
 
 struct DxilSourceInfo {
   uint32_t
@@ -318,6 +333,7 @@ enum class DxilSourceInfoSectionType : uint16_t {
   SourceContents = 0,
   SourceNames = 1,
   Args = 2,
+  SourceStoreKeys = 3,
 };
 
 struct DxilSourceInfoSection {
@@ -399,6 +415,20 @@ struct DxilSourceInfo_SourceContentsEntry {
   // 4-byte boundary.
 };
 
+enum class DxilSourceInfo_SourceStoreKeysVersion : uint32_t {
+  Version_0 = 0,
+  LatestPlus1,
+  Latest = LatestPlus1 - 1
+};
+
+struct DxilSourceInfo_SourceStoreKeys {
+  uint32_t Version; // DxilSourceInfo_SourceStoreKeysVersion. Readers must
+                    // reject versions they do not know.
+  uint32_t Count;   // The number of keys, one per source name.
+  // Followed by `Count` 16-byte MD5 digests of the source contents, in the
+  // order of the source names.
+};
+
 #pragma pack(pop)
 
 enum class DxilShaderPDBInfoVersion : uint16_t {
@@ -644,6 +674,7 @@ enum class SerializeDxilFlags : uint32_t {
   IncludeReflectionPart = 1 << 4,       // Include reflection in STAT part.
   StripRootSignature =
       1 << 5, // Strip Root Signature from main shader container.
+  FastShaderHash = 1 << 6, // Use xxHash64 rather than MD5 for the shader hash.
 };
 inline SerializeDxilFlags &operator|=(SerializeDxilFlags &l,
                                       const SerializeDxilFlags &r) {
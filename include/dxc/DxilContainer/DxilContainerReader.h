@@ -15,6 +15,7 @@
 #include "dxc/Support/Global.h"
 #include "dxc/Support/WinIncludes.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
 
 namespace hlsl {
 
@@ -22,6 +23,35 @@ const uint32_t DXIL_CONTAINER_BLOB_NOT_FOUND = UINT_MAX;
 
 struct DxilContainerHeader;
 
+//============================================================================
+// DxilPartIndex
+//
+// Maps each FourCC to the first part of that kind in a container. The table
+// is built once from a validated container header, so callers that look up
+// several parts don't rescan the part offset table for every query.
+//
+class DxilPartIndex {
+public:
+  DxilPartIndex() {}
+  explicit DxilPartIndex(const DxilContainerHeader *pHeader) { Init(pHeader); }
+
+  // Builds the index. pHeader must point to a valid container that outlives
+  // the index.
+  void Init(const DxilContainerHeader *pHeader);
+  void Clear();
+
+  // Returns the index of the first part of the given kind, or
+  // DXIL_CONTAINER_BLOB_NOT_FOUND.
+  uint32_t FindFirstPartIndex(uint32_t fourCC) const;
+  // Returns the first part of the given kind, or nullptr.
+  const DxilPartHeader *GetPartByType(uint32_t fourCC) const;
+
+private:
+  const DxilContainerHeader *m_pHeader = nullptr;
+  // (FourCC, part index) pairs, sorted by FourCC.
+  llvm::SmallVector<std::pair<uint32_t, uint32_t>, 16> m_FirstParts;
+};
+
 //============================================================================
 // DxilContainerReader
 //
@@ -63,6 +93,7 @@ private:
   const void *m_pContainer = nullptr;
   uint32_t m_uContainerSize = 0;
   const DxilContainerHeader *m_pHeader = nullptr;
+  DxilPartIndex m_PartIndex;
 
   bool IsLoaded() const { return m_pHeader != nullptr; }
 };
@@ -11,12 +11,14 @@
 
 #include "dxc/DxilContainer/DxilRuntimeReflection.h"
 #include "dxc/Support/WinIncludes.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -59,42 +61,32 @@ class IndexArraysPart : public RDATPart {
 private:
   std::vector<uint32_t> m_IndexBuffer;
 
-  // Use m_IndexSet with CmpIndices to avoid duplicate index arrays
-  struct CmpIndices {
-    const IndexArraysPart &Table;
-    CmpIndices(const IndexArraysPart &table) : Table(table) {}
-    bool operator()(uint32_t left, uint32_t right) const {
-      const uint32_t *pLeft = Table.m_IndexBuffer.data() + left;
-      const uint32_t *pRight = Table.m_IndexBuffer.data() + right;
-      if (*pLeft != *pRight)
-        return (*pLeft < *pRight);
-      uint32_t count = *pLeft;
-      for (unsigned i = 0; i < count; i++) {
-        ++pLeft;
-        ++pRight;
-        if (*pLeft != *pRight)
-          return (*pLeft < *pRight);
-      }
-      return false;
-    }
-  };
-  std::set<uint32_t, CmpIndices> m_IndexSet;
+  // Offsets of the arrays in m_IndexBuffer keyed by a hash of the count and
+  // elements, used to avoid duplicate index arrays.
+  std::unordered_multimap<size_t, uint32_t> m_IndexMap;
 
 public:
-  IndexArraysPart() : m_IndexBuffer(), m_IndexSet(*this) {}
+  IndexArraysPart() {}
   template <class iterator> uint32_t AddIndex(iterator begin, iterator end) {
     uint32_t newOffset = m_IndexBuffer.size();
     m_IndexBuffer.push_back(0); // Size: update after insertion
     m_IndexBuffer.insert(m_IndexBuffer.end(), begin, end);
-    m_IndexBuffer[newOffset] = (m_IndexBuffer.size() - newOffset) - 1;
+    uint32_t count = (m_IndexBuffer.size() - newOffset) - 1;
+    m_IndexBuffer[newOffset] = count;
+    const uint32_t *pNew = m_IndexBuffer.data() + newOffset;
+    size_t hash = llvm::hash_combine_range(pNew, pNew + count + 1);
     // Check for duplicate, return new offset if not duplicate
-    auto insertResult = m_IndexSet.insert(newOffset);
-    if (insertResult.second)
-      return newOffset;
-    // Otherwise it was a duplicate, so chop off the size and return the
-    // original
-    m_IndexBuffer.resize(newOffset);
-    return *insertResult.first;
+    auto range = m_IndexMap.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      const uint32_t *pOld = m_IndexBuffer.data() + it->second;
+      if (*pOld == count && std::equal(pNew + 1, pNew + count + 1, pOld + 1)) {
+        // It was a duplicate, so chop off the size and return the original
+        m_IndexBuffer.resize(newOffset);
+        return it->second;
+      }
+    }
+    m_IndexMap.emplace(hash, newOffset);
+    return newOffset;
   }
 
   RDAT::RuntimeDataPartType GetType() const {
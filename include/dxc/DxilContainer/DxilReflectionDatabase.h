@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// DxilReflectionDatabase.h                                                  //
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+// This file is distributed under the University of Illinois Open Source     //
+// License. See LICENSE.TXT for details.                                     //
+//                                                                           //
+// Layout of the reflection database written by                              //
+// IDxcUtils2::CreateReflectionDatabase.                                     //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "dxc/Support/WinIncludes.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace hlsl {
+
+// The database starts with a DxilReflectionDatabaseHeader, followed by one
+// table per DxilReflectionDatabaseTable kind. Each table is an array of
+// fixed-size records, like the tables of the RDAT part. Records refer to each
+// other by index and to names by offset into the string buffer, which holds
+// null-terminated UTF-8 strings; offset 0 is the empty string.
+//
+// There is one shader record per input container, in input order. A
+// container that could not be reflected has a failing Result and no other
+// records.
+
+static const uint32_t DxilReflectionDatabaseVersion = 1;
+
+enum class DxilReflectionDatabaseTable : uint32_t {
+  Shaders = 0,
+  Resources,
+  ConstantBuffers,
+  Variables,
+  SignatureElements,
+  StringBuffer, // RecordSize is 1.
+  Count
+};
+
+struct DxilReflectionDatabaseTableDesc {
+  uint32_t Offset; // From the start of the database.
+  uint32_t RecordCount;
+  uint32_t RecordSize;
+};
+
+struct DxilReflectionDatabaseHeader {
+  uint32_t Version; // DxilReflectionDatabaseVersion
+  uint32_t TableCount;
+  DxilReflectionDatabaseTableDesc
+      Tables[(uint32_t)DxilReflectionDatabaseTable::Count];
+};
+
+struct DxilReflectionDatabaseShader {
+  uint32_t Result;         // HRESULT of reflecting the container.
+  uint32_t ProgramVersion; // Shader kind and model, as in DxilProgramHeader.
+  uint32_t ThreadGroupSize[3];
+  uint32_t FirstResource;
+  uint32_t ResourceCount;
+  uint32_t FirstConstantBuffer;
+  uint32_t ConstantBufferCount;
+  // Input, then output, then patch constant elements.
+  uint32_t FirstSignatureElement;
+  uint32_t InputCount;
+  uint32_t OutputCount;
+  uint32_t PatchConstantCount;
+};
+
+// Fields match D3D12_SHADER_INPUT_BIND_DESC.
+struct DxilReflectionDatabaseResource {
+  uint32_t Name;
+  uint32_t Type;
+  uint32_t BindPoint;
+  uint32_t BindCount;
+  uint32_t Flags;
+  uint32_t ReturnType;
+  uint32_t Dimension;
+  uint32_t NumSamples;
+  uint32_t Space;
+};
+
+// Fields match D3D12_SHADER_BUFFER_DESC.
+struct DxilReflectionDatabaseConstantBuffer {
+  uint32_t Name;
+  uint32_t Type;
+  uint32_t Size;
+  uint32_t Flags;
+  uint32_t FirstVariable;
+  uint32_t VariableCount;
+};
+
+// Top-level variables of a constant buffer. Fields match
+// D3D12_SHADER_VARIABLE_DESC and D3D12_SHADER_TYPE_DESC.
+struct DxilReflectionDatabaseVariable {
+  uint32_t Name;
+  uint32_t StartOffset;
+  uint32_t Size;
+  uint32_t Flags;
+  uint32_t TypeName;
+  uint32_t Class;
+  uint32_t Type;
+  uint32_t Rows;
+  uint32_t Columns;
+  uint32_t Elements;
+  uint32_t Members;
+};
+
+// Fields match D3D12_SIGNATURE_PARAMETER_DESC.
+struct DxilReflectionDatabaseSignatureElement {
+  uint32_t SemanticName;
+  uint32_t SemanticIndex;
+  uint32_t Register;
+  uint32_t SystemValueType;
+  uint32_t ComponentType;
+  uint32_t Mask;
+  uint32_t ReadWriteMask;
+  uint32_t Stream;
+  uint32_t MinPrecision;
+};
+
+// Records of one container before they are merged into the database. Indices
+// and string offsets are local to the entry.
+struct DxilReflectionDatabaseEntry {
+  DxilReflectionDatabaseShader Shader = {};
+  std::vector<DxilReflectionDatabaseResource> Resources;
+  std::vector<DxilReflectionDatabaseConstantBuffer> ConstantBuffers;
+  std::vector<DxilReflectionDatabaseVariable> Variables;
+  std::vector<DxilReflectionDatabaseSignatureElement> SignatureElements;
+  std::string Strings = std::string(1, '\0');
+};
+
+// Reflects one container into Entry. Only reads the container, so entries for
+// different containers can be created concurrently.
+HRESULT CreateDxilReflectionDatabaseEntry(const void *pContainer, size_t size,
+                                          DxilReflectionDatabaseEntry &Entry);
+
+// Merges the entries, in order, into the database layout.
+void WriteDxilReflectionDatabase(
+    const std::vector<DxilReflectionDatabaseEntry> &Entries,
+    std::vector<char> &Database);
+
+} // namespace hlsl
@@ -34,6 +34,19 @@ namespace RDAT {
 //      byte UTF8Data[part.Size];
 //    - else if part.Type is Index:
 //      uint32_t IndexData[part.Size / 4];
+//
+// Reading:
+//  DxilRuntimeData and the *_Reader classes are views over the RDAT part
+//  bytes; they neither copy nor allocate, so they can be used directly on a
+//  memory-mapped container. The RDAT bytes must outlive every reader obtained
+//  from them. Tables and arrays support range-based for:
+//
+//    DxilRuntimeData RDAT(pPartData, partSize);
+//    for (RuntimeDataFunctionInfo_Reader F : RDAT.GetFunctionTable())
+//      for (RuntimeDataResourceInfo_Reader R : F.getResources())
+//        ...
+//
+//  Use Validate() first when the data is not trusted.
 
 enum RuntimeDataVersion {
   // Cannot be mistaken for part count from prerelease version
@@ -365,6 +378,29 @@ public:
   const RDATContext *GetContext() const { return m_pContext; }
 };
 
+// Forward iterator over a RecordTableReader, RecordArrayReader or
+// StringArrayReader. Dereferencing returns the element by value, which is
+// another view into the RDAT data.
+template <typename _ContainerTy, typename _ValueTy> class RecordIterator {
+  const _ContainerTy *m_pContainer;
+  uint32_t m_Index;
+
+public:
+  RecordIterator(const _ContainerTy *pContainer, uint32_t index)
+      : m_pContainer(pContainer), m_Index(index) {}
+  _ValueTy operator*() const { return (*m_pContainer)[m_Index]; }
+  RecordIterator &operator++() {
+    ++m_Index;
+    return *this;
+  }
+  bool operator==(const RecordIterator &other) const {
+    return m_pContainer == other.m_pContainer && m_Index == other.m_Index;
+  }
+  bool operator!=(const RecordIterator &other) const {
+    return !(*this == other);
+  }
+};
+
 template <typename _ReaderTy> class RecordArrayReader {
   const RDATContext *m_pContext;
   const uint32_t m_IndexOffset;
@@ -395,6 +431,9 @@ public:
     }
     return {};
   }
+  typedef RecordIterator<RecordArrayReader, _ReaderTy> iterator;
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, Count()); }
   // Is this a valid reader
   operator bool() const {
     return m_pContext != nullptr && m_IndexOffset < RDAT_NULL_REF;
@@ -418,6 +457,9 @@ public:
                        m_pContext->IndexTable.getRow(m_IndexOffset).At(idx))
                  : 0;
   }
+  typedef RecordIterator<StringArrayReader, const char *> iterator;
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, Count()); }
   // Is this a valid reader
   operator bool() const {
     return m_pContext != nullptr && m_IndexOffset < RDAT_NULL_REF;
@@ -635,7 +677,10 @@ public:
   }
   uint32_t size() const { return Count(); }
   const _RecordReader operator[](uint32_t index) const { return Row(index); }
-  operator bool() { return m_pContext && Count(); }
+  typedef RecordIterator<RecordTableReader, _RecordReader> iterator;
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, Count()); }
+  operator bool() const { return m_pContext && Count(); }
 };
 
 /////////////////////////////
@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// DxilSourceInfoReader.h                                                    //
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+// This file is distributed under the University of Illinois Open Source     //
+// License. See LICENSE.TXT for details.                                     //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+//
+// Helpers for reading a hlsl::DxilSourceInfo part and the sources it keeps
+// in an external source store.
+//
+#pragma once
+
+#include "dxc/DxilContainer/DxilContainer.h"
+#include "dxc/Support/Global.h"
+#include "llvm/ADT/StringRef.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct IMalloc;
+struct IDxcBlobEncoding;
+
+namespace hlsl {
+
+struct SourceInfoReader {
+  using Buffer = std::vector<uint8_t>;
+  Buffer m_UncompressedSources;
+
+  struct Source {
+    llvm::StringRef Name;
+    llvm::StringRef Content;
+    // If not empty, the content is kept in an external source store under
+    // this key, see -Qsource_store, and Content is empty.
+    std::string StoreKey;
+  };
+
+  struct ArgPair {
+    std::string Name;
+    std::string Value;
+  };
+
+  std::vector<Source> m_Sources;
+  std::vector<ArgPair> m_ArgPairs;
+
+  const Source &GetSource(unsigned i) const { return m_Sources[i]; }
+  unsigned GetSourcesCount() const { return m_Sources.size(); }
+
+  const ArgPair &GetArgPair(unsigned i) const { return m_ArgPairs[i]; }
+  unsigned GetArgPairCount() const { return m_ArgPairs.size(); }
+
+  // Note: The memory for SourceInfo must outlive this structure.
+  bool Init(const hlsl::DxilSourceInfo *SourceInfo, unsigned sourceInfoSize);
+};
+
+// Reads the source kept under key in the source store directory. Fails if the
+// source cannot be read, or if its content does not hash to the key, as for a
+// stale or overwritten store entry.
+HRESULT ReadSourceFromStore(IMalloc *pMalloc, llvm::StringRef storeDirectory,
+                            llvm::StringRef key, IDxcBlobEncoding **ppContent);
+
+} // namespace hlsl
@@ -10,11 +10,16 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #pragma once
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SparseBitVector.h"
+#include "llvm/ADT/iterator_range.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Dominators.h"
+#include "llvm/IR/ValueMap.h"
+#include "llvm/Pass.h"
 
-#include <unordered_map>
-#include <unordered_set>
+#include <memory>
+#include <vector>
 
 namespace llvm {
 class Function;
@@ -23,32 +28,91 @@ class raw_ostream;
 
 namespace hlsl {
 
-using BasicBlockSet = std::unordered_set<llvm::BasicBlock *>;
 using PostDomRelationType = llvm::DominatorTreeBase<llvm::BasicBlock>;
 
+// Blocks are numbered densely in post-order of the post-dominator tree and
+// the blocks each block is control dependent on are kept as a bit vector of
+// block numbers.
 class ControlDependence {
+  using BlockBitSet = llvm::SparseBitVector<>;
+  using BasicBlockVector = std::vector<llvm::BasicBlock *>;
+
 public:
+  class BlockIterator {
+  public:
+    BlockIterator(const BasicBlockVector &Blocks, BlockBitSet::iterator It)
+        : m_pBlocks(&Blocks), m_It(It) {}
+    llvm::BasicBlock *operator*() const { return (*m_pBlocks)[*m_It]; }
+    BlockIterator &operator++() {
+      ++m_It;
+      return *this;
+    }
+    bool operator==(const BlockIterator &Other) const {
+      return m_It == Other.m_It;
+    }
+    bool operator!=(const BlockIterator &Other) const {
+      return m_It != Other.m_It;
+    }
+
+  private:
+    const BasicBlockVector *m_pBlocks;
+    BlockBitSet::iterator m_It;
+  };
+  using BlockRange = llvm::iterator_range<BlockIterator>;
+
   void Compute(llvm::Function *F, PostDomRelationType &PostDomRel);
   void Clear();
-  const BasicBlockSet &GetCDBlocks(llvm::BasicBlock *pBB) const;
-  void print(llvm::raw_ostream &OS);
-  void dump();
+  // Blocks pBB is control dependent on, in block number order.
+  BlockRange GetCDBlocks(llvm::BasicBlock *pBB) const;
+  void print(llvm::raw_ostream &OS) const;
+  void dump() const;
 
 private:
-  using BasicBlockVector = std::vector<llvm::BasicBlock *>;
-  using ControlDependenceType =
-      std::unordered_map<llvm::BasicBlock *, BasicBlockSet>;
-
   llvm::Function *m_pFunc;
-  ControlDependenceType m_ControlDependence;
-  BasicBlockSet m_EmptyBBSet;
-
-  llvm::BasicBlock *GetIPostDom(PostDomRelationType &PostDomRel,
-                                llvm::BasicBlock *pBB);
-  void ComputeRevTopOrderRec(PostDomRelationType &PostDomRel,
-                             llvm::BasicBlock *pBB,
-                             BasicBlockVector &RevTopOrder,
-                             BasicBlockSet &VisitedBBs);
+  BasicBlockVector m_Blocks;
+  llvm::DenseMap<llvm::BasicBlock *, unsigned> m_BlockNumbers;
+  std::vector<BlockBitSet> m_ControlDependence;
+  BlockBitSet m_EmptyBBSet;
+
+  unsigned GetBlockNumber(llvm::BasicBlock *pBB) const;
+  void NumberBlocks(PostDomRelationType &PostDomRel, llvm::BasicBlock *pBB);
+};
+
+// Caches the post-dominator tree and the control dependence of functions for
+// the passes that need them. It only depends on the CFG, so it stays valid
+// across passes that preserve the CFG, and entries of deleted functions are
+// dropped.
+class ControlDependenceAnalysis : public llvm::ModulePass {
+public:
+  static char ID; // Pass identification, replacement for typeid
+  ControlDependenceAnalysis();
+
+  llvm::StringRef getPassName() const override {
+    return "DXIL Control Dependence";
+  }
+  bool runOnModule(llvm::Module &M) override { return false; }
+  void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
+    AU.setPreservesAll();
+  }
+  void releaseMemory() override { m_FuncInfo.clear(); }
+
+  PostDomRelationType &GetPostDomRelation(llvm::Function *F);
+  const ControlDependence &GetControlDependence(llvm::Function *F);
+
+private:
+  struct FuncInfo {
+    FuncInfo() : PostDomRel(/*isPostDom*/ true), bCtrlDepComputed(false) {}
+    PostDomRelationType PostDomRel;
+    ControlDependence CtrlDep;
+    bool bCtrlDepComputed;
+  };
+  llvm::ValueMap<const llvm::Function *, std::unique_ptr<FuncInfo>> m_FuncInfo;
+
+  FuncInfo &GetFuncInfo(llvm::Function *F);
 };
 
 } // namespace hlsl
+
+namespace llvm {
+void initializeControlDependenceAnalysisPass(llvm::PassRegistry &);
+} // namespace llvm
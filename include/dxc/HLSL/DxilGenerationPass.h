@@ -19,14 +19,16 @@ class FunctionPass;
 class Instruction;
 class PassRegistry;
 class StringRef;
-struct PostDominatorTree;
+class BasicBlock;
+template <class NodeT> class DominatorTreeBase;
 } // namespace llvm
 
 namespace hlsl {
 class DxilResourceBase;
 class WaveSensitivityAnalysis {
 public:
-  static WaveSensitivityAnalysis *create(llvm::PostDominatorTree &PDT);
+  static WaveSensitivityAnalysis *
+  create(llvm::DominatorTreeBase<llvm::BasicBlock> &PDT);
   virtual ~WaveSensitivityAnalysis() {}
   virtual void Analyze(llvm::Function *F) = 0;
   virtual bool IsWaveSensitive(llvm::Instruction *op) = 0;
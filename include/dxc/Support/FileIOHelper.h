@@ -149,6 +149,13 @@ HRESULT DxcCreateBlobFromFile(IMalloc *pMalloc, LPCWSTR pFileName,
 HRESULT DxcCreateBlobFromFile(LPCWSTR pFileName, UINT32 *pCodePage,
                               IDxcBlobEncoding **ppBlobEncoding) throw();
 
+// Like DxcCreateBlobFromFile for a binary file, but the blob is backed by a
+// read-only llvm::MemoryBuffer, which maps large files instead of copying
+// them. The file must not change while the blob is alive. The blob opens the
+// file with its own file system, so no per-thread file system is needed.
+HRESULT DxcCreateBlobFromFileMapped(IMalloc *pMalloc, LPCWSTR pFileName,
+                                    IDxcBlobEncoding **ppBlobEncoding) throw();
+
 // Given a blob, creates a subrange view.
 HRESULT DxcCreateBlobFromBlob(IDxcBlob *pBlob, UINT32 offset, UINT32 length,
                               IDxcBlob **ppResult) throw();
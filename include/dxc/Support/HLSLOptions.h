@@ -143,6 +143,8 @@ public:
   llvm::StringRef OutputRootSigFile;          // OPT_Frs
   llvm::StringRef OutputShaderHashFile;       // OPT_Fsh
   llvm::StringRef OutputFileForDependencies;  // OPT_write_dependencies_to
+  llvm::StringRef ServerSocket;               // OPT__server
+  llvm::StringRef ConnectSocket;              // OPT__connect
   std::string Preprocess;                     // OPT_P
   llvm::StringRef TargetProfile;              // OPT_target_profile
   llvm::StringRef VariableName;               // OPT_Vn
@@ -157,6 +159,8 @@ public:
   llvm::StringRef ImportBindingTable;         // OPT_import_binding_table
   llvm::StringRef BindingTableDefine;         // OPT_binding_table_define
   llvm::StringRef DiagnosticsFormat;          // OPT_fdiagnostics_format
+  llvm::StringRef SourceCompression;          // OPT_Qsource_compression
+  llvm::StringRef SourceStore;                // OPT_Qsource_store
   unsigned DefaultTextCodePage = DXC_CP_UTF8; // OPT_encoding
 
   bool AllResourcesBound = false;         // OPT_all_resources_bound
@@ -209,6 +213,7 @@ public:
   bool SourceInDebugModule = false;          // OPT Zs
   bool SourceOnlyDebug = false;              // OPT Qsource_only_debug
   bool PdbInPrivate = false;                 // OPT Qpdb_in_private
+  bool FastShaderHash = false;               // OPT_Qfast_shader_hash
   bool StripRootSignature = false;           // OPT_Qstrip_rootsignature
   bool StripPrivate = false;                 // OPT_Qstrip_priv
   bool StripReflection = false;              // OPT_Qstrip_reflect
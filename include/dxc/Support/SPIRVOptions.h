@@ -20,9 +20,13 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Option/ArgList.h"
 
+#include <memory>
+
 namespace clang {
 namespace spirv {
 
+class OptimizerCache;
+
 enum class SpirvLayoutRule {
   Void,
   GLSLStd140,
@@ -51,6 +55,8 @@ struct SpirvCodeGenOptions {
   bool enable16BitTypes;
   bool finiteMathOnly;
   bool enableReflect;
+  /// Return a compact reflection blob for the module as the reflection output
+  bool emitReflectionBlob;
   bool invertY; // Additive inverse
   bool invertW; // Multiplicative inverse
   bool noWarnEmulatedFeatures;
@@ -92,11 +98,33 @@ struct SpirvCodeGenOptions {
   std::vector<std::string> bindRegister;
   std::vector<std::string> bindGlobals;
   std::string entrypointName;
+  /// Entry points that are each translated into their own module. The
+  /// translation unit is only parsed once for all of them.
+  llvm::SmallVector<llvm::StringRef, 4> entryPoints;
+  /// The module of each entry point in entryPoints, in the same order.
+  /// Filled in by the SPIR-V codegen.
+  std::vector<std::vector<uint32_t>> entryPointModules;
 
   bool signaturePacking; ///< Whether signature packing is enabled or not
 
   bool printAll; // Dump SPIR-V module before each pass and after the last one.
 
+  bool timeReport; // Collect per-pass timing of the SPIR-V optimizer.
+
+  // Per-pass timing and module size statistics of the SPIR-V optimizer runs.
+  // Filled in by the SPIR-V codegen when timeReport is set.
+  std::string optimizerTimeReport;
+
+  bool stripDebugInfo; // Strip debug info from the returned module.
+
+  // The module before debug info was stripped from it. Filled in by the SPIR-V
+  // codegen when stripDebugInfo is set.
+  std::vector<uint32_t> debugModule;
+
+  // Optimizers kept between compilations on the same compiler object. No
+  // optimizers are kept if not set.
+  std::shared_ptr<OptimizerCache> optimizerCache;
+
   // String representation of all command line options and input file.
   std::string clOptions;
   std::string inputFile;
@@ -255,6 +255,7 @@
 
 #define _Out_
 #define _Out_opt_
+#define _Out_writes_(size)
 #define _Outptr_
 #define _Outptr_opt_
 #define _Outptr_result_z_
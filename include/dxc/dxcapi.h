@@ -717,6 +717,47 @@ struct IDxcUtils : public IUnknown {
                  _COM_Outptr_ IDxcBlob **ppContainer) = 0;
 };
 
+static const UINT32 DxcLoadFileFlags_None = 0;
+/// Binary files are backed by a read-only mapping of the file instead of a
+/// copy on the heap, where the file is large enough for mapping to pay off.
+/// The file must not change or be truncated while the blob is alive, and on
+/// Windows it cannot be written or deleted until the blob is released. Text
+/// files, loaded with a code page, are always copied.
+static const UINT32 DxcLoadFileFlags_Map = 1;
+
+CROSS_PLATFORM_UUIDOF(IDxcUtils2, "B3F5A1C2-7D4E-4C8B-9E21-5A6F0D3C8E47")
+/// \brief Various utility functions for DXC, including batch reflection.
+///
+/// Use DxcCreateInstance with CLSID_DxcUtils to obtain an instance of this
+/// interface.
+struct IDxcUtils2 : public IDxcUtils {
+  /// \brief Reflect many DXIL containers into one reflection database.
+  ///
+  /// The database holds the resource bindings, constant buffer layouts,
+  /// signatures and thread group size of every container, laid out as in
+  /// dxc/DxilContainer/DxilReflectionDatabase.h. The containers are reflected
+  /// concurrently, without creating a reflection interface for each one. A
+  /// container that can't be reflected gets a shader record with a failing
+  /// result instead of failing the whole call.
+  virtual HRESULT STDMETHODCALLTYPE CreateReflectionDatabase(
+      _In_count_(containerCount)
+          const DxcBuffer *pContainers, ///< DXIL containers to reflect.
+      _In_ UINT32 containerCount,       ///< Number of containers.
+      _COM_Outptr_ IDxcBlob **ppDatabase ///< Receives the database.
+      ) = 0;
+
+  /// \brief Create a blob with data loaded from a file.
+  ///
+  /// Same as IDxcUtils::LoadFile, with DxcLoadFileFlags_* values to choose
+  /// how the file is loaded.
+  virtual HRESULT STDMETHODCALLTYPE LoadFileWithFlags(
+      _In_z_ LPCWSTR pFileName,    ///< The name of the file to load from.
+      _In_opt_ UINT32 *pCodePage,  ///< Optional code page of text data.
+      _In_ UINT32 flags,           ///< DxcLoadFileFlags_* values.
+      _COM_Outptr_ IDxcBlobEncoding **ppBlobEncoding ///< Receives the blob.
+      ) = 0;
+};
+
 /// \brief Specifies the kind of output to retrieve from a IDxcResult.
 ///
 /// Note: text outputs returned from version 2 APIs are UTF-8 or UTF-16 based on
@@ -865,6 +906,57 @@ struct IDxcCompiler3 : public IUnknown {
       ) = 0;
 };
 
+/// \brief A set of defines selecting one permutation of a shader.
+///
+/// Used by IDxcCompiler4::CompilePermutations.
+struct DxcDefineSet {
+  _In_count_(defineCount) const DxcDefine *pDefines; ///< Array of defines.
+  UINT32 defineCount; ///< Number of defines.
+};
+
+static const UINT32 DxcCompilePermutationsFlags_None = 0;
+/// Permutations whose preprocessed source is identical to an earlier
+/// permutation are not compiled again; they receive the result of that
+/// earlier permutation. Every permutation is preprocessed first, so this only
+/// pays off when many permutations are expected to be identical. It is
+/// ignored when the shared arguments enable debug info (-Zi, -Zs,
+/// -Qembed_debug, -Qsource_in_debug_module), which records the defines of
+/// each permutation, or read the root signature from a define
+/// (-rootsig-define).
+static const UINT32 DxcCompilePermutationsFlags_Deduplicate = 1;
+
+CROSS_PLATFORM_UUIDOF(IDxcCompiler4, "0BB8639B-DAB6-42AB-A5B9-32DB754B4CDF")
+/// \brief Interface to the DirectX Shader Compiler.
+///
+/// Use DxcCreateInstance with CLSID_DxcCompiler to obtain an instance of this
+/// interface.
+struct IDxcCompiler4 : public IDxcCompiler3 {
+  /// \brief Compile the same source under several sets of defines.
+  ///
+  /// Each permutation is compiled as if Compile() was called with the shared
+  /// arguments followed by a -D argument for each of its defines. Compared to
+  /// separate Compile() calls, the source is converted to UTF-8 once, each
+  /// include file is loaded and converted once for all permutations, and the
+  /// permutations are compiled concurrently. The include handler is never
+  /// called concurrently.
+  virtual HRESULT STDMETHODCALLTYPE CompilePermutations(
+      _In_ const DxcBuffer *pSource, ///< Source text to compile.
+      _In_opt_count_(argCount)
+          LPCWSTR *pArguments, ///< Array of pointers to shared arguments.
+      _In_ UINT32 argCount,    ///< Number of shared arguments.
+      _In_count_(permutationCount)
+          const DxcDefineSet *pPermutations, ///< Defines of each permutation.
+      _In_ UINT32 permutationCount,          ///< Number of permutations.
+      _In_ UINT32 flags, ///< DxcCompilePermutationsFlags_* values.
+      _In_opt_ IDxcIncludeHandler
+          *pIncludeHandler, ///< user-provided interface to handle include
+                            ///< directives (optional).
+      _Out_writes_(permutationCount)
+          IDxcResult **ppResults ///< Array that receives one result for
+                                 ///< each permutation.
+      ) = 0;
+};
+
 static const UINT32 DxcValidatorFlags_Default = 0;
 static const UINT32 DxcValidatorFlags_InPlaceEdit =
     1; // Validator is allowed to update shader blob in-place.
@@ -1219,6 +1311,22 @@ struct IDxcPdbUtils2 : public IUnknown {
   virtual BOOL STDMETHODCALLTYPE IsPDBRef() = 0;
 };
 
+CROSS_PLATFORM_UUIDOF(IDxcPdbUtils3, "6E4C6D1F-2C7B-4D0A-9F55-3A8E0B7C21D4")
+/// \brief DxcPdbUtils interface with source store support.
+///
+/// Use DxcCreateInstance with CLSID_DxcPdbUtils to create an instance of this.
+struct IDxcPdbUtils3 : public IDxcPdbUtils2 {
+  /// \brief Set the directory that sources compiled with -Qsource_store are
+  /// read from.
+  ///
+  /// Sources stored by key are only resolved against this directory, never
+  /// against a path recorded in the PDB. Without a store directory, or if a
+  /// stored file no longer matches its key, they are returned with empty
+  /// contents. Takes effect on the next Load().
+  virtual HRESULT STDMETHODCALLTYPE
+  SetSourceStore(_In_opt_z_ LPCWSTR pStoreDirectory) = 0;
+};
+
 // Note: __declspec(selectany) requires 'extern'
 // On Linux __declspec(selectany) is removed and using 'extern' results in link
 // error.
@@ -188,6 +188,15 @@ struct __declspec(uuid("9c2a040d-8068-44ec-8c68-8bfef1b43789"))
       _COM_Outptr_ IDxcPixCompilationInfo **ppCompilationInfo) = 0;
 };
 
+// Implemented by the DXC DIA data source (CLSID_DxcDiaDataSource).
+struct __declspec(uuid("2a926e28-1f5e-46a5-8f51-a1bf7ea41eeb"))
+    IDxcPixSourceStore : public IUnknown {
+  // Sets the directory that sources compiled with -Qsource_store are read
+  // from. Must be called before the PDB is loaded. Sources that are missing
+  // from the store or no longer match their key are returned empty.
+  virtual STDMETHODIMP SetSourceStore(_In_opt_z_ LPCWSTR pStoreDirectory) = 0;
+};
+
 #ifndef CLSID_SCOPE
 #ifdef _MSC_VER
 #define CLSID_SCOPE __declspec(selectany) extern
@@ -51,6 +51,12 @@ class DominatorTree;
 ///
 Module *CloneModule(const Module *M);
 Module *CloneModule(const Module *M, ValueToValueMapTy &VMap);
+// HLSL Change Begin - Allow cloning only the declarations.
+/// If CloneDefinitions is false, function definitions are cloned as
+/// declarations, as if their bodies had been deleted after cloning.
+Module *CloneModule(const Module *M, ValueToValueMapTy &VMap,
+                    bool CloneDefinitions);
+// HLSL Change End
 
 /// ClonedCodeInfo - This struct can be used to capture information about code
 /// being cloned, while it is being cloned.
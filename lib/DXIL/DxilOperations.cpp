@@ -3447,7 +3447,6 @@ OP::OP(LLVMContext &Ctx, Module *pModule)
       m_LowPrecisionMode(DXIL::LowPrecisionMode::Undefined) {
   memset(m_pResRetType, 0, sizeof(m_pResRetType));
   memset(m_pCBufferRetType, 0, sizeof(m_pCBufferRetType));
-  memset(m_OpCodeClassCache, 0, sizeof(m_OpCodeClassCache));
   static_assert(_countof(OP::m_OpCodeProps) == (size_t)OP::OpCode::NumOpCodes,
                 "forgot to update OP::m_OpCodeProps");
 
@@ -3575,7 +3574,7 @@ Function *OP::GetOpFunc(OpCode opCode, Type *pOverloadType) {
     return F;
   }
 
-  vector<Type *> ArgTypes; // RetType is ArgTypes[0]
+  SmallVector<Type *, 16> ArgTypes; // RetType is ArgTypes[0]
   Type *pETy = pOverloadType;
   Type *pRes = GetHandleType();
   Type *pNodeHandle = GetNodeHandleType();
@@ -5520,13 +5519,26 @@ Function *OP::GetOpFunc(OpCode opCode, Type *pOverloadType) {
 
   UpdateCache(opClass, pOverloadType, F);
   F->setCallingConv(CallingConv::C);
-  F->addFnAttr(Attribute::NoUnwind);
-  if (m_OpCodeProps[(unsigned)opCode].FuncAttr != Attribute::None)
-    F->addFnAttr(m_OpCodeProps[(unsigned)opCode].FuncAttr);
+  F->setAttributes(GetOpFuncAttributes(opCode));
 
   return F;
 }
 
+AttributeSet OP::GetOpFuncAttributes(OpCode opCode) {
+  // Every dxil operation shares one of a handful of function attribute sets.
+  // Build each set once instead of merging attributes into every new function.
+  Attribute::AttrKind FuncAttr = m_OpCodeProps[(unsigned)opCode].FuncAttr;
+  AttributeSet &Attrs = m_OpFuncAttributes[(unsigned)FuncAttr];
+  if (Attrs.isEmpty()) {
+    AttrBuilder B;
+    B.addAttribute(Attribute::NoUnwind);
+    if (FuncAttr != Attribute::None)
+      B.addAttribute(FuncAttr);
+    Attrs = AttributeSet::get(m_Ctx, AttributeSet::FunctionIndex, B);
+  }
+  return Attrs;
+}
+
 const SmallMapVector<llvm::Type *, llvm::Function *, 8> &
 OP::GetOpFuncList(OpCode opCode) const {
   return m_OpCodeClassCache[(unsigned)m_OpCodeProps[(unsigned)opCode]
@@ -47,6 +47,9 @@ static const uint32_t kPdbStreamIndex =
 static const uint32_t kDataStreamIndex =
     5; // This is the fixed stream index where we will store our custom data.
 static const uint32_t kMsfBlockSize = 512;
+// Block size used once the block map no longer fits in a single 512 byte
+// block, which limits 512 byte block PDBs to roughly 8 MB.
+static const uint32_t kMsfLargeBlockSize = 4096;
 
 // The superblock is overlaid at the beginning of the file (offset 0).
 // It starts with a magic header and is followed by information which
@@ -91,30 +94,45 @@ struct MSFWriter {
     ArrayRef<char> Data;
     unsigned NumBlocks = 0;
   };
-  struct StreamLayout {
-    MSF_SuperBlock SB;
-  };
 
-  int m_NumBlocks = 0;
+  uint32_t m_BlockSize = kMsfBlockSize;
+  uint32_t m_NumBlocks = 0;
   SmallVector<Stream, 8> m_Streams;
 
-  static uint32_t GetNumBlocks(uint32_t Size) {
-    return CalculateNumBlocks(kMsfBlockSize, Size);
+  uint32_t GetNumBlocks(uint32_t Size) const {
+    return CalculateNumBlocks(m_BlockSize, Size);
   }
 
   uint32_t AddStream(ArrayRef<char> Data) {
     uint32_t ID = m_Streams.size();
     Stream S;
     S.Data = Data;
-    S.NumBlocks = GetNumBlocks(Data.size());
-    m_NumBlocks += S.NumBlocks;
     m_Streams.push_back(S);
     return ID;
   }
 
   uint32_t AddEmptyStream() { return AddStream({}); }
 
-  uint32_t CalculateDirectorySize() {
+  // Lays out the streams with the given block size. Returns false if the
+  // stream directory is too large for its block map to fit in one block.
+  bool LayoutStreams(uint32_t BlockSize) {
+    m_BlockSize = BlockSize;
+    m_NumBlocks = 0;
+    for (Stream &S : m_Streams) {
+      S.NumBlocks = GetNumBlocks(S.Data.size());
+      m_NumBlocks += S.NumBlocks;
+    }
+    const uint32_t NumDirectoryBlocks =
+        GetNumBlocks(CalculateDirectorySize());
+    return NumDirectoryBlocks * sizeof(support::ulittle32_t) <= m_BlockSize;
+  }
+
+  void LayoutStreams() {
+    if (!LayoutStreams(kMsfBlockSize))
+      LayoutStreams(kMsfLargeBlockSize);
+  }
+
+  uint32_t CalculateDirectorySize() const {
     uint32_t DirectorySizeInBytes = 0;
     DirectorySizeInBytes += sizeof(uint32_t);
     DirectorySizeInBytes += m_Streams.size() * 4;
@@ -124,10 +142,10 @@ struct MSFWriter {
     return DirectorySizeInBytes;
   }
 
-  MSF_SuperBlock CalculateSuperblock() {
+  MSF_SuperBlock CalculateSuperblock() const {
     MSF_SuperBlock SB = {};
     memcpy(SB.MagicBytes, kMsfMagic, sizeof(kMsfMagic));
-    SB.BlockSize = kMsfBlockSize;
+    SB.BlockSize = m_BlockSize;
     SB.NumDirectoryBytes = CalculateDirectorySize();
     SB.NumBlocks = 3 + m_NumBlocks + GetNumBlocks(SB.NumDirectoryBytes);
     SB.FreeBlockMapBlock = 1;
@@ -135,57 +153,24 @@ struct MSFWriter {
     return SB;
   }
 
-  struct BlockWriter {
-    uint32_t BlocksWritten = 0;
-    raw_ostream &OS;
-
-    BlockWriter(raw_ostream &OS) : OS(OS) {}
-
-    void WriteZeroPads(uint32_t Count) {
-      for (unsigned i = 0; i < Count; i++)
-        OS.write(0);
-    }
-
-    void WriteEmptyBlock() {
-      BlocksWritten++;
-      WriteZeroPads(kMsfBlockSize);
-    }
-
-    void WriteBlocks(uint32_t NumBlocks, const void *Data, uint32_t Size) {
-      assert(NumBlocks >= GetNumBlocks(Size) &&
-             "Cannot fit data into the requested number of blocks!");
-      uint32_t TotalSize = NumBlocks * kMsfBlockSize;
-      OS.write(static_cast<char *>(const_cast<void *>(Data)), Size);
-      WriteZeroPads(TotalSize - Size);
-      BlocksWritten += NumBlocks;
-    }
-
-    void WriteUint32(uint32_t Value) {
-      support::ulittle32_t ValueLE;
-      ValueLE = Value;
-      OS.write((char *)&ValueLE, sizeof(ValueLE));
-    }
-  };
-
-  void WriteBlocks(raw_ostream &OS, ArrayRef<char> Data, uint32_t NumBlocks) {
-    assert(NumBlocks >= GetNumBlocks(Data.size()) &&
-           "Cannot fit data into the requested number of blocks!");
-    uint32_t TotalSize = NumBlocks * kMsfBlockSize;
-    OS.write(Data.data(), Data.size());
-    WriteZeroPadding(OS, TotalSize - Data.size());
-  }
-  void WriteZeroPadding(raw_ostream &OS, int Count) {
-    for (int i = 0; i < Count; i++)
-      OS.write(0);
+  // Size of the whole file: super block, two FPM blocks, block map,
+  // directory and streams. Only valid after LayoutStreams.
+  size_t CalculateFileSize() const {
+    const uint32_t NumDirectoryBlocks = GetNumBlocks(CalculateDirectorySize());
+    const uint32_t NumBlockAddrBlocks =
+        GetNumBlocks(NumDirectoryBlocks * sizeof(support::ulittle32_t));
+    return (size_t)(3 + NumBlockAddrBlocks + NumDirectoryBlocks +
+                    m_NumBlocks) *
+           m_BlockSize;
   }
 
-  static support::ulittle32_t MakeUint32LE(uint32_t Value) {
-    support::ulittle32_t ValueLE;
-    ValueLE = Value;
-    return ValueLE;
+  static void WriteUint32(char *pDst, uint32_t Value) {
+    support::endian::write32le(pDst, Value);
   }
 
-  void WriteToStream(raw_ostream &OS) {
+  // Writes the file into pDst, which must be CalculateFileSize() bytes and
+  // zero-filled; padding is not written.
+  void WriteToBuffer(char *pDst) const {
     MSF_SuperBlock SB = CalculateSuperblock();
     const uint32_t NumDirectoryBlocks = GetNumBlocks(SB.NumDirectoryBytes);
     const uint32_t StreamDirectoryAddr = SB.BlockMapAddr;
@@ -196,53 +181,46 @@ struct MSFWriter {
         StreamDirectoryAddr + NumBlockAddrBlocks;
     const uint32_t StreamStart = StreamDirectoryStart + NumDirectoryBlocks;
 
-    BlockWriter Writer(OS);
-    Writer.WriteBlocks(1, &SB, sizeof(SB)); // Super Block
-    Writer.WriteEmptyBlock();               // FPM 1
-    Writer.WriteEmptyBlock();               // FPM 2
+    // Super Block, followed by the two empty FPM blocks.
+    memcpy(pDst, &SB, sizeof(SB));
 
     // BlockAddr
     // This block contains a list of uint32's that point to the blocks that
     // make up the stream directory.
     {
-      SmallVector<support::ulittle32_t, 4> BlockAddr;
-      uint32_t Start = StreamDirectoryStart;
-      for (unsigned i = 0; i < NumDirectoryBlocks; i++) {
-        support::ulittle32_t V;
-        V = Start++;
-        BlockAddr.push_back(V);
-      }
-      assert(BlockAddrSize == sizeof(BlockAddr[0]) * BlockAddr.size());
-      Writer.WriteBlocks(NumBlockAddrBlocks, BlockAddr.data(), BlockAddrSize);
+      char *pBlockAddr = pDst + (size_t)StreamDirectoryAddr * m_BlockSize;
+      for (unsigned i = 0; i < NumDirectoryBlocks; i++)
+        WriteUint32(pBlockAddr + i * sizeof(uint32_t),
+                    StreamDirectoryStart + i);
     }
 
-    // Stream Directory. Describes where all the streams are
-    // Looks like this:
-    //
+    // Stream Directory. Describes where all the streams are: the number of
+    // streams, the size of each stream, then the blocks of each stream.
     {
-      SmallVector<support::ulittle32_t, 32> StreamDirectoryData;
-      StreamDirectoryData.push_back(MakeUint32LE(m_Streams.size()));
+      char *pDirectory = pDst + (size_t)StreamDirectoryStart * m_BlockSize;
+      WriteUint32(pDirectory, m_Streams.size());
+      pDirectory += sizeof(uint32_t);
       for (unsigned i = 0; i < m_Streams.size(); i++) {
-        StreamDirectoryData.push_back(MakeUint32LE(m_Streams[i].Data.size()));
+        WriteUint32(pDirectory, m_Streams[i].Data.size());
+        pDirectory += sizeof(uint32_t);
       }
       uint32_t Start = StreamStart;
       for (unsigned i = 0; i < m_Streams.size(); i++) {
-        auto &Stream = m_Streams[i];
-        for (unsigned j = 0; j < Stream.NumBlocks; j++) {
-          StreamDirectoryData.push_back(MakeUint32LE(Start++));
+        for (unsigned j = 0; j < m_Streams[i].NumBlocks; j++) {
+          WriteUint32(pDirectory, Start++);
+          pDirectory += sizeof(uint32_t);
         }
       }
-      Writer.WriteBlocks(NumDirectoryBlocks, StreamDirectoryData.data(),
-                         StreamDirectoryData.size() *
-                             sizeof(StreamDirectoryData[0]));
     }
 
     // Write the streams.
     {
+      char *pStreamData = pDst + (size_t)StreamStart * m_BlockSize;
       for (unsigned i = 0; i < m_Streams.size(); i++) {
-        auto &Stream = m_Streams[i];
-        Writer.WriteBlocks(Stream.NumBlocks, Stream.Data.data(),
-                           Stream.Data.size());
+        const Stream &S = m_Streams[i];
+        if (!S.Data.empty())
+          memcpy(pStreamData, S.Data.data(), S.Data.size());
+        pStreamData += (size_t)S.NumBlocks * m_BlockSize;
       }
     }
   }
@@ -334,16 +312,24 @@ HRESULT hlsl::pdb::WriteDxilPDB(IMalloc *pMalloc,
       llvm::ArrayRef<char>((const char *)ContainerData.data(),
                            ContainerData.size())); // Actual data block
 
-  CComPtr<hlsl::AbstractMemoryStream> pStream;
-  IFR(hlsl::CreateMemoryStream(pMalloc, &pStream));
-
-  raw_stream_ostream OS(pStream);
-  Writer.WriteToStream(OS);
-  OS.flush();
-
-  IFR(pStream.QueryInterface(ppOutBlob));
-
-  return S_OK;
+  // Lay the file out up front so it can be written straight into a single
+  // allocation that the output blob takes ownership of.
+  Writer.LayoutStreams();
+  const size_t FileSize = Writer.CalculateFileSize();
+  if (FileSize > UINT32_MAX)
+    return E_OUTOFMEMORY;
+
+  char *pData = (char *)pMalloc->Alloc(FileSize);
+  if (!pData)
+    return E_OUTOFMEMORY;
+  memset(pData, 0, FileSize);
+  Writer.WriteToBuffer(pData);
+
+  HRESULT hr = hlsl::DxcCreateBlobOnMalloc(pData, pMalloc, (UINT32)FileSize,
+                                           ppOutBlob);
+  if (FAILED(hr))
+    pMalloc->Free(pData);
+  return hr;
 }
 
 struct PDBReader {
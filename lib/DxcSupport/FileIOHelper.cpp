@@ -16,6 +16,9 @@
 #include "dxc/Support/WinIncludes.h"
 #include "dxc/Support/microcom.h"
 #include "dxc/dxcapi.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MSFileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 #include <algorithm>
 #include <memory>
@@ -848,6 +851,87 @@ HRESULT DxcCreateBlobFromFile(LPCWSTR pFileName, UINT32 *pCodePage,
                                ppBlobEncoding);
 }
 
+// Blob that owns an llvm::MemoryBuffer, which may be a read-only mapping of
+// the underlying file. On Windows, unmapping goes through the per-thread file
+// system, so the blob keeps the file system it was opened with and installs
+// it again while releasing the buffer; the caller's may be gone by then.
+class MemoryBufferBlob : public IDxcBlob {
+private:
+  DXC_MICROCOM_TM_REF_FIELDS()
+  std::unique_ptr<llvm::sys::fs::MSFileSystem> m_pFileSystem;
+  std::unique_ptr<llvm::MemoryBuffer> m_pBuffer;
+
+public:
+  DXC_MICROCOM_TM_ADDREF_RELEASE_IMPL()
+  DXC_MICROCOM_TM_CTOR(MemoryBufferBlob)
+
+  ~MemoryBufferBlob() {
+    llvm::sys::fs::AutoPerThreadSystem pts(m_pFileSystem.get());
+    m_pBuffer.reset();
+  }
+
+  HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid,
+                                           void **ppvObject) override {
+    return DoBasicQueryInterface<IDxcBlob>(this, iid, ppvObject);
+  }
+
+  void Init(std::unique_ptr<llvm::sys::fs::MSFileSystem> pFileSystem,
+            std::unique_ptr<llvm::MemoryBuffer> pBuffer) {
+    m_pFileSystem = std::move(pFileSystem);
+    m_pBuffer = std::move(pBuffer);
+  }
+
+  LPVOID STDMETHODCALLTYPE GetBufferPointer(void) override {
+    return const_cast<char *>(m_pBuffer->getBufferStart());
+  }
+  SIZE_T STDMETHODCALLTYPE GetBufferSize(void) override {
+    return m_pBuffer->getBufferSize();
+  }
+};
+
+HRESULT
+DxcCreateBlobFromFileMapped(IMalloc *pMalloc, LPCWSTR pFileName,
+                            IDxcBlobEncoding **ppBlobEncoding) throw() {
+  if (pFileName == nullptr || ppBlobEncoding == nullptr) {
+    return E_POINTER;
+  }
+
+  *ppBlobEncoding = nullptr;
+  if (!pMalloc)
+    pMalloc = DxcGetThreadMallocNoRef();
+
+  try {
+    std::string fileName;
+    IFRBOOL(Unicode::WideToUTF8String(pFileName, &fileName), E_INVALIDARG);
+
+    llvm::sys::fs::MSFileSystem *msfPtr;
+    IFR(CreateMSFileSystemForDisk(&msfPtr));
+    std::unique_ptr<llvm::sys::fs::MSFileSystem> msf(msfPtr);
+
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> pBufferOrErr =
+        std::make_error_code(std::errc::no_such_file_or_directory);
+    {
+      llvm::sys::fs::AutoPerThreadSystem pts(msf.get());
+      IFTLLVM(pts.error_code());
+      pBufferOrErr = llvm::MemoryBuffer::getFile(
+          fileName, /*FileSize*/ -1, /*RequiresNullTerminator*/ false);
+    }
+    // Report failures the same way as the copying path.
+    if (!pBufferOrErr)
+      return DxcCreateBlobFromFile(pMalloc, pFileName, nullptr,
+                                   ppBlobEncoding);
+    if (pBufferOrErr.get()->getBufferSize() > UINT32_MAX)
+      return DXC_E_INPUT_FILE_TOO_LARGE;
+
+    CComPtr<MemoryBufferBlob> pBlob = MemoryBufferBlob::Alloc(pMalloc);
+    IFROOM(pBlob.p);
+    pBlob->Init(std::move(msf), std::move(pBufferOrErr.get()));
+    return DxcCreateBlobEncodingFromBlob(pBlob, 0, 0, /*encodingKnown*/ false,
+                                         0, pMalloc, ppBlobEncoding);
+  }
+  CATCH_CPP_RETURN_HRESULT();
+}
+
 HRESULT
 DxcCreateBlobWithEncodingSet(IMalloc *pMalloc, IDxcBlob *pBlob, UINT32 codePage,
                              IDxcBlobEncoding **ppBlobEncoding) throw() {
@@ -326,8 +326,14 @@ static bool hasUnsupportedSpirvOption(const InputArgList &args,
   // Note: The options checked here are non-exhaustive. A thorough audit of
   // available options and their current compatibility is needed to generate a
   // complete list.
-  std::vector<OptSpecifier> unsupportedOpts = {OPT_Fd, OPT_Fre, OPT_Gec,
-                                               OPT_Gis, OPT_Qstrip_reflect};
+  std::vector<OptSpecifier> unsupportedOpts = {OPT_Gec, OPT_Gis,
+                                               OPT_Qstrip_reflect};
+  // -Fd writes the debug-rich module, which is only kept with -Qstrip_debug.
+  if (!args.hasFlag(OPT_Qstrip_debug, OPT_INVALID, false))
+    unsupportedOpts.push_back(OPT_Fd);
+  // -Fre writes the reflection blob, which only -fspv-reflect-blob returns.
+  if (!args.hasFlag(OPT_fspv_reflect_blob, OPT_INVALID, false))
+    unsupportedOpts.push_back(OPT_Fre);
 
   for (const auto &id : unsupportedOpts) {
     if (Arg *arg = args.getLastArg(id)) {
@@ -433,6 +439,14 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
     return 0;
   }
 
+  // The compile server takes its compilations from clients, so it doesn't
+  // need any of the other arguments.
+  opts.ServerSocket = Args.getLastArgValue(OPT__server);
+  if (!opts.ServerSocket.empty()) {
+    return 0;
+  }
+  opts.ConnectSocket = Args.getLastArgValue(OPT__connect);
+
   if (missingArgCount) {
     errors << "Argument to '" << Args.getArgString(missingArgIndex)
            << "' is missing.";
@@ -784,6 +798,19 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
       Args.hasFlag(OPT_Qsource_in_debug_module, OPT_INVALID, false);
   opts.SourceOnlyDebug = Args.hasFlag(OPT_Zs, OPT_INVALID, false);
   opts.PdbInPrivate = Args.hasFlag(OPT_Qpdb_in_private, OPT_INVALID, false);
+  opts.SourceCompression = Args.getLastArgValue(OPT_Qsource_compression);
+  if (!opts.SourceCompression.empty() &&
+      !(opts.SourceCompression.equals_lower("none") ||
+        opts.SourceCompression.equals_lower("fast") ||
+        opts.SourceCompression.equals_lower("default") ||
+        opts.SourceCompression.equals_lower("best"))) {
+    errors << "Unsupported value '" << opts.SourceCompression
+           << "' for Qsource_compression option.";
+    return 1;
+  }
+  opts.SourceStore = Args.getLastArgValue(OPT_Qsource_store);
+  opts.FastShaderHash =
+      Args.hasFlag(OPT_Qfast_shader_hash, OPT_INVALID, false);
   opts.StripRootSignature =
       Args.hasFlag(OPT_Qstrip_rootsignature, OPT_INVALID, false);
   opts.StripPrivate = Args.hasFlag(OPT_Qstrip_priv, OPT_INVALID, false);
@@ -1060,6 +1087,8 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
       Args.hasFlag(OPT_fspv_use_legacy_buffer_matrix_order, OPT_INVALID, false);
   opts.SpirvOptions.enableReflect =
       Args.hasFlag(OPT_fspv_reflect, OPT_INVALID, false);
+  opts.SpirvOptions.emitReflectionBlob =
+      Args.hasFlag(OPT_fspv_reflect_blob, OPT_INVALID, false);
   opts.SpirvOptions.noWarnIgnoredFeatures =
       Args.hasFlag(OPT_Wno_vk_ignored_features, OPT_INVALID, false);
   opts.SpirvOptions.noWarnEmulatedFeatures =
@@ -1196,6 +1225,24 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
   opts.SpirvOptions.entrypointName =
       Args.getLastArgValue(OPT_fspv_entrypoint_name_EQ);
 
+  for (const Arg *A : Args.filtered(OPT_fspv_entry_points_EQ)) {
+    for (const auto v : A->getValues())
+      opts.SpirvOptions.entryPoints.push_back(v);
+  }
+  if (!opts.SpirvOptions.entryPoints.empty()) {
+    // Each entry point gets its own module, but there is only one PDB,
+    // reflection output and -fspv-entrypoint-name.
+    if (!opts.SpirvOptions.entrypointName.empty() || opts.StripDebug ||
+        opts.SpirvOptions.emitReflectionBlob) {
+      errors << "-fspv-entry-points cannot be used together with "
+                "-fspv-entrypoint-name, -Qstrip_debug or -fspv-reflect-blob";
+      return 1;
+    }
+    // The first entry point is checked to exist while parsing, like -E.
+    if (!opts.IsLibraryProfile() && !Args.hasArg(OPT_entrypoint))
+      opts.EntryPoint = opts.SpirvOptions.entryPoints.front();
+  }
+
   // Check for use of options not implemented in the SPIR-V backend.
   if (Args.hasFlag(OPT_spirv, OPT_INVALID, false) &&
       hasUnsupportedSpirvOption(Args, errors))
@@ -1214,6 +1261,7 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
       Args.hasFlag(OPT_fspv_flatten_resource_arrays, OPT_INVALID, false) ||
       Args.hasFlag(OPT_fspv_reduce_load_size, OPT_INVALID, false) ||
       Args.hasFlag(OPT_fspv_reflect, OPT_INVALID, false) ||
+      Args.hasFlag(OPT_fspv_reflect_blob, OPT_INVALID, false) ||
       Args.hasFlag(OPT_fspv_fix_func_call_arguments, OPT_INVALID, false) ||
       Args.hasFlag(OPT_fspv_print_all, OPT_INVALID, false) ||
       Args.hasFlag(OPT_Wno_vk_ignored_features, OPT_INVALID, false) ||
@@ -1226,6 +1274,7 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
       !Args.getLastArgValue(OPT_fspv_extension_EQ).empty() ||
       !Args.getLastArgValue(OPT_fspv_target_env_EQ).empty() ||
       !Args.getLastArgValue(OPT_Oconfig).empty() ||
+      !Args.getLastArgValue(OPT_fspv_entry_points_EQ).empty() ||
       !Args.getLastArgValue(OPT_fvk_bind_register).empty() ||
       !Args.getLastArgValue(OPT_fvk_bind_globals).empty() ||
       !Args.getLastArgValue(OPT_fvk_b_shift).empty() ||
@@ -1257,6 +1306,11 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
     return 1;
   }
 
+  if (opts.SourceInDebugModule && !opts.SourceStore.empty()) {
+    errors << "Cannot specify both /Qsource_in_debug_module and /Qsource_store";
+    return 1;
+  }
+
   if (opts.DebugInfo && !opts.DebugNameForBinary && !opts.DebugNameForSource) {
     opts.DebugNameForBinary = true;
   } else if (opts.DebugNameForBinary && opts.DebugNameForSource) {
@@ -1360,6 +1414,9 @@ SerializeDxilFlags ComputeSerializeDxilFlags(const options::DxcOpts &opts) {
   if (opts.StripRootSignature) {
     SerializeFlags |= SerializeDxilFlags::StripRootSignature;
   }
+  if (opts.FastShaderHash) {
+    SerializeFlags |= SerializeDxilFlags::FastShaderHash;
+  }
   return SerializeFlags;
 }
 
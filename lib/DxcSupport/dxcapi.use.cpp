@@ -87,6 +87,12 @@ void ReadFileIntoBlob(DxcDllSupport &dxcSupport, LPCWSTR pFileName,
            pFileName);
 }
 
+void MapFileIntoBlob(LPCWSTR pFileName, IDxcBlobEncoding **ppBlobEncoding) {
+  IFT_Data(hlsl::DxcCreateBlobFromFileMapped(nullptr, pFileName,
+                                             ppBlobEncoding),
+           pFileName);
+}
+
 void WriteOperationErrorsToConsole(IDxcOperationResult *pResult,
                                    bool outputWarnings) {
   HRESULT status;
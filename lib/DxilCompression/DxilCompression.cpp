@@ -27,7 +27,8 @@ namespace {
 class Zlib {
 public:
   enum Operation { INFLATE, DEFLATE };
-  Zlib(Operation Op, IMalloc *pAllocator)
+  Zlib(Operation Op, IMalloc *pAllocator,
+       int CompressionLevel = Z_DEFAULT_COMPRESSION)
       : m_Stream{}, m_Op(Op), m_Initalized(false) {
     m_Stream = {};
 
@@ -41,7 +42,7 @@ public:
     if (Op == INFLATE) {
       ret = inflateInit(&m_Stream);
     } else {
-      ret = deflateInit(&m_Stream, Z_DEFAULT_COMPRESSION);
+      ret = deflateInit(&m_Stream, CompressionLevel);
     }
 
     if (ret != Z_OK) {
@@ -72,6 +73,17 @@ public:
     return m_InitializationResult;
   }
 
+  static int TranslateCompressionLevel(hlsl::ZlibCompressionLevel Level) {
+    switch (Level) {
+    case hlsl::ZlibCompressionLevel::Fast:
+      return Z_BEST_SPEED;
+    case hlsl::ZlibCompressionLevel::Best:
+      return Z_BEST_COMPRESSION;
+    default:
+      return Z_DEFAULT_COMPRESSION;
+    }
+  }
+
   static hlsl::ZlibResult TranslateZlibResult(int zlibResult) {
     switch (zlibResult) {
     default:
@@ -128,8 +140,9 @@ hlsl::ZlibResult hlsl::ZlibDecompress(IMalloc *pMalloc,
 hlsl::ZlibResult hlsl::ZlibCompress(IMalloc *pMalloc, const void *pData,
                                     size_t pDataSize, void *pUserData,
                                     ZlibCallbackFn *Callback,
-                                    size_t *pOutCompressedSize) {
-  Zlib zlib(Zlib::DEFLATE, pMalloc);
+                                    size_t *pOutCompressedSize,
+                                    ZlibCompressionLevel Level) {
+  Zlib zlib(Zlib::DEFLATE, pMalloc, Zlib::TranslateCompressionLevel(Level));
   z_stream *pStream = zlib.GetStream();
   if (!pStream)
     return zlib.GetInitializationResult();
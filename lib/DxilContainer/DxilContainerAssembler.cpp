@@ -36,7 +36,9 @@
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Operator.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/MD5.h"
+#include "llvm/Support/xxhash.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include <algorithm>
 #include <assert.h> // Needed for DxilPipelineStateValidation.h
@@ -2086,8 +2088,11 @@ static std::unique_ptr<Module> CloneModuleForReflection(Module *pM) {
   // Emit the latest reflection metadata
   hlsl::ReEmitLatestReflectionData(pM);
 
-  // Clone module
-  std::unique_ptr<Module> reflectionModule(llvm::CloneModule(pM));
+  // Clone module. Function bodies are not part of reflection, so skip them
+  // rather than cloning and then deleting them.
+  ValueToValueMapTy VMap;
+  std::unique_ptr<Module> reflectionModule(
+      llvm::CloneModule(pM, VMap, /*CloneDefinitions*/ false));
 
   // Now restore validator version on main module and re-emit metadata.
   DM.SetValidatorVersion(ValMajor, ValMinor);
@@ -2359,18 +2364,28 @@ void hlsl::SerializeDxilContainerForModule(
     // If the debug name should be specific to the sources, base the name on the
     // debug bitcode, which will include the source references, line numbers,
     // etc. Otherwise, do it exclusively on the target shader bitcode.
-    llvm::MD5 md5;
+    ArrayRef<uint8_t> HashedBitcode;
     if (Flags & SerializeDxilFlags::DebugNameDependOnSource) {
-      md5.update(ArrayRef<uint8_t>(pModuleBitcode->GetPtr(),
-                                   pModuleBitcode->GetPtrSize()));
+      HashedBitcode = ArrayRef<uint8_t>(pModuleBitcode->GetPtr(),
+                                        pModuleBitcode->GetPtrSize());
       HashContent.Flags = (uint32_t)DxilShaderHashFlags::IncludesSource;
     } else {
-      md5.update(ArrayRef<uint8_t>(pProgramStream->GetPtr(),
-                                   pProgramStream->GetPtrSize()));
+      HashedBitcode = ArrayRef<uint8_t>(pProgramStream->GetPtr(),
+                                        pProgramStream->GetPtrSize());
       HashContent.Flags = (uint32_t)DxilShaderHashFlags::None;
     }
-    md5.final(HashContent.Digest);
-    md5.stringifyResult(HashContent.Digest, HashStr);
+    if (Flags & SerializeDxilFlags::FastShaderHash) {
+      // One pass over the bitcode; the upper half of the digest stays zero.
+      uint64_t Hash = llvm::xxHash64(HashedBitcode, 0);
+      llvm::support::endian::write64le(HashContent.Digest, Hash);
+      llvm::support::endian::write64le(HashContent.Digest + 8, 0);
+      HashContent.Flags |= (uint32_t)DxilShaderHashFlags::XXHash64;
+    } else {
+      llvm::MD5 md5;
+      md5.update(HashedBitcode);
+      md5.final(HashContent.Digest);
+    }
+    llvm::MD5::stringifyResult(HashContent.Digest, HashStr);
   }
 
   // Serialize debug name if requested.
@@ -14,8 +14,54 @@
 #include "dxc/Support/Global.h"
 #include "dxc/WinAdapter.h"
 
+#include <algorithm>
+
 namespace hlsl {
 
+void DxilPartIndex::Init(const DxilContainerHeader *pHeader) {
+  m_pHeader = pHeader;
+  m_FirstParts.clear();
+  m_FirstParts.reserve(pHeader->PartCount);
+  for (uint32_t i = 0; i < pHeader->PartCount; ++i)
+    m_FirstParts.emplace_back(GetDxilContainerPart(pHeader, i)->PartFourCC, i);
+  // Stable sort keeps the first part of each kind ahead of any duplicates.
+  std::stable_sort(m_FirstParts.begin(), m_FirstParts.end(),
+                   [](const std::pair<uint32_t, uint32_t> &LHS,
+                      const std::pair<uint32_t, uint32_t> &RHS) {
+                     return LHS.first < RHS.first;
+                   });
+  m_FirstParts.erase(
+      std::unique(m_FirstParts.begin(), m_FirstParts.end(),
+                  [](const std::pair<uint32_t, uint32_t> &LHS,
+                     const std::pair<uint32_t, uint32_t> &RHS) {
+                    return LHS.first == RHS.first;
+                  }),
+      m_FirstParts.end());
+}
+
+void DxilPartIndex::Clear() {
+  m_pHeader = nullptr;
+  m_FirstParts.clear();
+}
+
+uint32_t DxilPartIndex::FindFirstPartIndex(uint32_t fourCC) const {
+  auto it = std::lower_bound(
+      m_FirstParts.begin(), m_FirstParts.end(), fourCC,
+      [](const std::pair<uint32_t, uint32_t> &Entry, uint32_t FourCC) {
+        return Entry.first < FourCC;
+      });
+  if (it == m_FirstParts.end() || it->first != fourCC)
+    return DXIL_CONTAINER_BLOB_NOT_FOUND;
+  return it->second;
+}
+
+const DxilPartHeader *DxilPartIndex::GetPartByType(uint32_t fourCC) const {
+  uint32_t idx = FindFirstPartIndex(fourCC);
+  if (idx == DXIL_CONTAINER_BLOB_NOT_FOUND)
+    return nullptr;
+  return GetDxilContainerPart(m_pHeader, idx);
+}
+
 HRESULT DxilContainerReader::Load(const void *pContainer,
                                   uint32_t containerSizeInBytes) {
   if (pContainer == nullptr) {
@@ -34,6 +80,7 @@ HRESULT DxilContainerReader::Load(const void *pContainer,
   m_pContainer = pContainer;
   m_uContainerSize = containerSizeInBytes;
   m_pHeader = pHeader;
+  m_PartIndex.Init(pHeader);
 
   return S_OK;
 }
@@ -92,9 +139,7 @@ HRESULT DxilContainerReader::FindFirstPartKind(uint32_t kind,
   *pResult = 0;
   if (!IsLoaded())
     return E_NOT_VALID_STATE;
-  DxilPartIterator it =
-      std::find_if(begin(m_pHeader), end(m_pHeader), DxilPartIsType(kind));
-  *pResult = (it == end(m_pHeader)) ? DXIL_CONTAINER_BLOB_NOT_FOUND : it.index;
+  *pResult = m_PartIndex.FindFirstPartIndex(kind);
   return S_OK;
 }
 
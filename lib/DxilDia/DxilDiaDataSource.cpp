@@ -13,8 +13,11 @@
 
 #include "dxc/DXIL/DxilPDB.h"
 #include "dxc/DXIL/DxilUtil.h"
+#include "dxc/DXIL/DxilMetadataHelper.h"
 #include "dxc/DxilContainer/DxilContainer.h"
+#include "dxc/DxilPdbInfo/DxilSourceInfoReader.h"
 #include "dxc/Support/FileIOHelper.h"
+#include "dxc/Support/Unicode.h"
 #include "dxc/Support/dxcapi.impl.h"
 
 #include "llvm/Support/FileSystem.h"
@@ -69,6 +72,53 @@ getMemBufferFromStream(IStream *pStream, std::vector<char> &DataContainer,
       llvm::MemoryBuffer::getMemBuffer(Str, BufferName.str(), false));
   return result;
 }
+
+// Sources compiled with -Qsource_store are replaced by placeholders in the
+// debug module. Puts the sources resolved from the store in their place, so
+// that they are found like sources compiled with -Qsource_in_debug_module.
+static HRESULT ResolveStoredSources(IMalloc *pMalloc,
+                                    llvm::StringRef storeDirectory,
+                                    const hlsl::DxilPartHeader *pSourceInfoPart,
+                                    llvm::Module &M) {
+  hlsl::SourceInfoReader reader;
+  if (!reader.Init((const hlsl::DxilSourceInfo *)(pSourceInfoPart + 1),
+                   pSourceInfoPart->PartSize))
+    return E_FAIL;
+  if (reader.GetSourcesCount() == 0 || reader.GetSource(0).StoreKey.empty())
+    return S_OK;
+
+  llvm::LLVMContext &context = M.getContext();
+  llvm::NamedMDNode *sourceContents =
+      M.getNamedMetadata(hlsl::DxilMDHelper::kDxilSourceContentsMDName);
+  if (sourceContents)
+    sourceContents->eraseFromParent();
+  sourceContents = M.getOrInsertNamedMetadata(
+      hlsl::DxilMDHelper::kDxilSourceContentsMDName);
+  for (unsigned i = 0; i < reader.GetSourcesCount(); i++) {
+    const hlsl::SourceInfoReader::Source &source = reader.GetSource(i);
+    llvm::StringRef content;
+    CComPtr<IDxcBlobEncoding> pContent;
+    if (SUCCEEDED(hlsl::ReadSourceFromStore(pMalloc, storeDirectory,
+                                            source.StoreKey, &pContent)))
+      content = llvm::StringRef((const char *)pContent->GetBufferPointer(),
+                                pContent->GetBufferSize());
+    llvm::Metadata *operands[2] = {llvm::MDString::get(context, source.Name),
+                                   llvm::MDString::get(context, content)};
+    sourceContents->addOperand(llvm::MDTuple::get(context, operands));
+  }
+
+  // The main file is the first source.
+  llvm::NamedMDNode *mainFileName =
+      M.getNamedMetadata(hlsl::DxilMDHelper::kDxilSourceMainFileNameMDName);
+  if (mainFileName)
+    mainFileName->eraseFromParent();
+  mainFileName = M.getOrInsertNamedMetadata(
+      hlsl::DxilMDHelper::kDxilSourceMainFileNameMDName);
+  llvm::Metadata *nameOperand[1] = {
+      llvm::MDString::get(context, reader.GetSource(0).Name)};
+  mainFileName->addOperand(llvm::MDTuple::get(context, nameOperand));
+  return S_OK;
+}
 } // namespace dxil_dia
 
 STDMETHODIMP dxil_dia::DataSource::loadDataFromIStream(IStream *pInputIStream) {
@@ -88,6 +138,7 @@ STDMETHODIMP dxil_dia::DataSource::loadDataFromIStream(IStream *pInputIStream) {
 
     CComPtr<IStream> pIStream = pInputIStream;
     CComPtr<IDxcBlob> pContainer;
+    const hlsl::DxilPartHeader *pSourceInfoPart = nullptr;
     if (SUCCEEDED(hlsl::pdb::LoadDataFromStream(m_pMalloc, pInputIStream,
                                                 &pContainer))) {
       const hlsl::DxilContainerHeader *pContainerHeader =
@@ -100,6 +151,8 @@ STDMETHODIMP dxil_dia::DataSource::loadDataFromIStream(IStream *pInputIStream) {
           pContainerHeader, hlsl::DFCC_ShaderDebugInfoDXIL);
       if (!PartHeader)
         return E_FAIL;
+      pSourceInfoPart = hlsl::GetDxilPartByType(pContainerHeader,
+                                                hlsl::DFCC_ShaderSourceInfo);
       CComPtr<IDxcBlobEncoding> pPinnedBlob;
       IFR(hlsl::DxcCreateBlobWithEncodingFromPinned(
           PartHeader + 1, PartHeader->PartSize, CP_ACP, &pPinnedBlob));
@@ -155,6 +208,9 @@ STDMETHODIMP dxil_dia::DataSource::loadDataFromIStream(IStream *pInputIStream) {
                                               DiagStr);
     if (!pModule.get())
       return E_FAIL;
+    if (pSourceInfoPart && !m_sourceStore.empty())
+      IFR(ResolveStoredSources(m_pMalloc, m_sourceStore, pSourceInfoPart,
+                               *pModule));
     m_finder = std::make_shared<llvm::DebugInfoFinder>();
     m_finder->processModule(*pModule.get());
     m_module.reset(pModule.release());
@@ -183,6 +239,18 @@ STDMETHODIMP dxil_dia::DataSource::openSession(IDiaSession **ppSession) {
   return S_OK;
 }
 
+STDMETHODIMP dxil_dia::DataSource::SetSourceStore(LPCWSTR pStoreDirectory) {
+  if (!pStoreDirectory) {
+    m_sourceStore.clear();
+    return S_OK;
+  }
+  std::string storeDirectory;
+  if (!Unicode::WideToUTF8String(pStoreDirectory, &storeDirectory))
+    return E_INVALIDARG;
+  m_sourceStore = std::move(storeDirectory);
+  return S_OK;
+}
+
 HRESULT CreateDxcDiaDataSource(REFIID riid, LPVOID *ppv) {
   CComPtr<dxil_dia::DataSource> result =
       CreateOnMalloc<dxil_dia::DataSource>(DxcGetThreadMallocNoRef());
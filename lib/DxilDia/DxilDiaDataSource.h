@@ -14,11 +14,13 @@
 #include "dxc/Support/WinIncludes.h"
 
 #include <memory>
+#include <string>
 
 #include "dia2.h"
 
 #include "dxc/DXIL/DxilModule.h"
 #include "dxc/Support/Global.h"
+#include "dxc/dxcpix.h"
 
 #include "DxilDia.h"
 #include "DxilDiaTable.h"
@@ -26,18 +28,20 @@
 namespace dxil_dia {
 class Session;
 
-class DataSource : public IDiaDataSource {
+class DataSource : public IDiaDataSource, public IDxcPixSourceStore {
 private:
   DXC_MICROCOM_TM_REF_FIELDS()
   std::shared_ptr<llvm::Module> m_module;
   std::shared_ptr<llvm::LLVMContext> m_context;
   std::shared_ptr<llvm::DebugInfoFinder> m_finder;
+  std::string m_sourceStore;
 
 public:
   DXC_MICROCOM_TM_ADDREF_RELEASE_IMPL()
 
   STDMETHODIMP QueryInterface(REFIID iid, void **ppvObject) override {
-    return DoBasicQueryInterface<IDiaDataSource>(this, iid, ppvObject);
+    return DoBasicQueryInterface<IDiaDataSource, IDxcPixSourceStore>(
+        this, iid, ppvObject);
   }
 
   DataSource(IMalloc *pMalloc);
@@ -64,6 +68,8 @@ public:
 
   STDMETHODIMP openSession(IDiaSession **ppSession) override;
 
+  STDMETHODIMP SetSourceStore(LPCWSTR pStoreDirectory) override;
+
   HRESULT STDMETHODCALLTYPE loadDataFromCodeViewInfo(
       LPCOLESTR executable, LPCOLESTR searchPath, DWORD cbCvInfo,
       BYTE *pbCvInfo, IUnknown *pCallback) override {
@@ -0,0 +1,280 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// DxilSourceInfoReader.cpp                                                  //
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+// This file is distributed under the University of Illinois Open Source     //
+// License. See LICENSE.TXT for details.                                     //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "dxc/DxilPdbInfo/DxilSourceInfoReader.h"
+
+#include "dxc/Support/Global.h"
+#include "dxc/Support/WinIncludes.h"
+
+#include "dxc/DxilCompression/DxilCompression.h"
+#include "dxc/DxilContainer/DxilContainer.h"
+#include "dxc/Support/FileIOHelper.h"
+#include "dxc/Support/Unicode.h"
+#include "dxc/dxcapi.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/Path.h"
+
+using namespace hlsl;
+
+static size_t PointerByteOffset(const void *a, const void *b) {
+  return (const uint8_t *)a - (const uint8_t *)b;
+}
+
+bool SourceInfoReader::Init(const hlsl::DxilSourceInfo *SourceInfo,
+                            unsigned sourceInfoSize) {
+  if (sizeof(*SourceInfo) > sourceInfoSize)
+    return false;
+  if (SourceInfo->AlignedSizeInBytes > sourceInfoSize)
+    return false;
+
+  const hlsl::DxilSourceInfo *mainHeader = SourceInfo;
+  const size_t totalSizeInBytes = mainHeader->AlignedSizeInBytes;
+
+  const hlsl::DxilSourceInfoSection *section =
+      (const hlsl::DxilSourceInfoSection *)(SourceInfo + 1);
+  for (unsigned i = 0; i < SourceInfo->SectionCount; i++) {
+
+    if (PointerByteOffset(section + 1, mainHeader) > totalSizeInBytes)
+      return false;
+    if (PointerByteOffset(section, mainHeader) + section->AlignedSizeInBytes >
+        totalSizeInBytes)
+      return false;
+
+    const size_t sectionSizeInBytes = section->AlignedSizeInBytes;
+
+    switch (section->Type) {
+    case hlsl::DxilSourceInfoSectionType::Args: {
+      const hlsl::DxilSourceInfo_Args *header =
+          (const hlsl::DxilSourceInfo_Args *)(section + 1);
+
+      if (PointerByteOffset(header + 1, section) > sectionSizeInBytes)
+        return false;
+      if (PointerByteOffset(header + 1, section) + header->SizeInBytes >
+          sectionSizeInBytes)
+        return false;
+
+      const char *ptr = (const char *)(header + 1);
+      unsigned i = 0;
+      while (i < header->SizeInBytes) {
+
+        // To learn more about the format of this data, check struct
+        // DxilSourceInfo_Args in DxilContainer.h Read the argument name
+        const char *argName = ptr + i;
+        unsigned argNameLength = 0;
+        for (; i < header->SizeInBytes; i++) {
+          if (ptr[i] == '\0') {
+            i++;
+            break;
+          }
+          argNameLength++;
+        }
+
+        // Read the argument value
+        const char *argValue = ptr + i;
+        unsigned argValueLength = 0;
+        for (; i < header->SizeInBytes; i++) {
+          if (ptr[i] == '\0') {
+            i++;
+            break;
+          }
+          argValueLength++;
+        }
+
+        ArgPair pair = {};
+        assert(argNameLength || argValueLength);
+        if (argNameLength || argValueLength) {
+          if (argNameLength)
+            pair.Name.assign(argName, argNameLength);
+          if (argValueLength)
+            pair.Value.assign(argValue, argValueLength);
+          m_ArgPairs.push_back(std::move(pair));
+        }
+      }
+    } break;
+
+    case hlsl::DxilSourceInfoSectionType::SourceNames: {
+      const hlsl::DxilSourceInfo_SourceNames *header =
+          (const hlsl::DxilSourceInfo_SourceNames *)(section + 1);
+      if (PointerByteOffset(header + 1, section) > sectionSizeInBytes)
+        return false;
+      if (PointerByteOffset(header + 1, section) + header->EntriesSizeInBytes >
+          sectionSizeInBytes)
+        return false;
+
+      assert(m_Sources.size() == 0 || m_Sources.size() == header->Count);
+      m_Sources.resize(header->Count);
+
+      const hlsl::DxilSourceInfo_SourceNamesEntry *firstEntry =
+          (const hlsl::DxilSourceInfo_SourceNamesEntry *)(header + 1);
+      const hlsl::DxilSourceInfo_SourceNamesEntry *entry = firstEntry;
+
+      for (unsigned i = 0; i < header->Count; i++) {
+        if (PointerByteOffset(entry + 1, firstEntry) >
+            header->EntriesSizeInBytes)
+          return false;
+        if (PointerByteOffset(entry + 1, firstEntry) + entry->NameSizeInBytes >
+            header->EntriesSizeInBytes)
+          return false;
+        if (PointerByteOffset(entry, firstEntry) + entry->AlignedSizeInBytes >
+            header->EntriesSizeInBytes)
+          return false;
+
+        const void *ptr = entry + 1;
+        if (entry->NameSizeInBytes > 0) {
+          // Fail if not null terminated
+          if (((const char *)ptr)[entry->NameSizeInBytes - 1] != '\0')
+            return false;
+          llvm::StringRef name = {
+              (const char *)ptr,
+              entry->NameSizeInBytes - 1,
+          };
+          m_Sources[i].Name = name;
+        }
+
+        entry = (const hlsl::DxilSourceInfo_SourceNamesEntry
+                     *)((const uint8_t *)entry + entry->AlignedSizeInBytes);
+      }
+
+    } break;
+    case hlsl::DxilSourceInfoSectionType::SourceContents: {
+      const hlsl::DxilSourceInfo_SourceContents *header =
+          (const hlsl::DxilSourceInfo_SourceContents *)(section + 1);
+      if (PointerByteOffset(header + 1, section) > sectionSizeInBytes)
+        return false;
+      if (PointerByteOffset(header + 1, section) + header->EntriesSizeInBytes >
+          sectionSizeInBytes)
+        return false;
+
+      const hlsl::DxilSourceInfo_SourceContentsEntry *firstEntry = nullptr;
+      if (header->CompressType ==
+          hlsl::DxilSourceInfo_SourceContentsCompressType::Zlib) {
+        m_UncompressedSources.resize(header->UncompressedEntriesSizeInBytes);
+        {
+          bool bDecompressSucc =
+              hlsl::ZlibResult::Success ==
+              ZlibDecompress(DxcGetThreadMallocNoRef(), header + 1,
+                             header->EntriesSizeInBytes,
+                             m_UncompressedSources.data(),
+                             m_UncompressedSources.size());
+          assert(bDecompressSucc);
+          if (!bDecompressSucc)
+            return false;
+        }
+        if (m_UncompressedSources.size() !=
+            header->UncompressedEntriesSizeInBytes)
+          return false;
+        firstEntry = (const hlsl::DxilSourceInfo_SourceContentsEntry *)
+                         m_UncompressedSources.data();
+      } else {
+        if (header->EntriesSizeInBytes !=
+            header->UncompressedEntriesSizeInBytes)
+          return false;
+        if (PointerByteOffset(header + 1, section) +
+                header->UncompressedEntriesSizeInBytes >
+            sectionSizeInBytes)
+          return false;
+        firstEntry =
+            (const hlsl::DxilSourceInfo_SourceContentsEntry *)(header + 1);
+      }
+
+      assert(m_Sources.size() == 0 || m_Sources.size() == header->Count);
+      m_Sources.resize(header->Count);
+
+      const hlsl::DxilSourceInfo_SourceContentsEntry *entry = firstEntry;
+      for (unsigned i = 0; i < header->Count; i++) {
+        if (PointerByteOffset(entry + 1, firstEntry) >
+            header->UncompressedEntriesSizeInBytes)
+          return false;
+        if (PointerByteOffset(entry + 1, firstEntry) +
+                entry->ContentSizeInBytes >
+            header->UncompressedEntriesSizeInBytes)
+          return false;
+        if (PointerByteOffset(entry, firstEntry) + entry->AlignedSizeInBytes >
+            header->UncompressedEntriesSizeInBytes)
+          return false;
+
+        const void *ptr = entry + 1;
+        if (entry->ContentSizeInBytes > 0) {
+          // Fail if not null terminated
+          if (((const char *)ptr)[entry->ContentSizeInBytes - 1] != '\0')
+            return false;
+          llvm::StringRef content = {
+              (const char *)ptr,
+              entry->ContentSizeInBytes - 1,
+          };
+          m_Sources[i].Content = content;
+        }
+
+        entry = (const hlsl::DxilSourceInfo_SourceContentsEntry
+                     *)((const uint8_t *)entry + entry->AlignedSizeInBytes);
+      }
+    } break;
+    case hlsl::DxilSourceInfoSectionType::SourceStoreKeys: {
+      const hlsl::DxilSourceInfo_SourceStoreKeys *header =
+          (const hlsl::DxilSourceInfo_SourceStoreKeys *)(section + 1);
+      if (PointerByteOffset(header + 1, section) > sectionSizeInBytes)
+        return false;
+      if (header->Version >
+          (uint32_t)hlsl::DxilSourceInfo_SourceStoreKeysVersion::Latest)
+        return false;
+      if (PointerByteOffset(header + 1, section) +
+              (uint64_t)header->Count * sizeof(llvm::MD5::MD5Result) >
+          sectionSizeInBytes)
+        return false;
+
+      assert(m_Sources.size() == 0 || m_Sources.size() == header->Count);
+      m_Sources.resize(header->Count);
+
+      const uint8_t *digests = (const uint8_t *)(header + 1);
+      for (unsigned i = 0; i < header->Count; i++) {
+        llvm::MD5::MD5Result digest;
+        memcpy(digest, digests + i * sizeof(digest), sizeof(digest));
+        llvm::SmallString<32> key;
+        llvm::MD5::stringifyResult(digest, key);
+        m_Sources[i].StoreKey = key.str();
+      }
+    } break;
+    }
+    section =
+        (const hlsl::DxilSourceInfoSection *)((const uint8_t *)section +
+                                              section->AlignedSizeInBytes);
+  }
+
+  return true;
+}
+
+HRESULT hlsl::ReadSourceFromStore(IMalloc *pMalloc,
+                                  llvm::StringRef storeDirectory,
+                                  llvm::StringRef key,
+                                  IDxcBlobEncoding **ppContent) {
+  *ppContent = nullptr;
+  llvm::SmallString<256> path(storeDirectory);
+  llvm::sys::path::append(path, key);
+  std::wstring widePath;
+  if (!Unicode::UTF8ToWideString(path.c_str(), &widePath))
+    return E_INVALIDARG;
+
+  UINT32 codePage = CP_UTF8;
+  CComPtr<IDxcBlobEncoding> pContent;
+  IFR(DxcCreateBlobFromFile(pMalloc, widePath.c_str(), &codePage, &pContent));
+
+  llvm::MD5 hash;
+  hash.update(llvm::StringRef((const char *)pContent->GetBufferPointer(),
+                              pContent->GetBufferSize()));
+  llvm::MD5::MD5Result digest;
+  hash.final(digest);
+  llvm::SmallString<32> contentKey;
+  llvm::MD5::stringifyResult(digest, contentKey);
+  if (contentKey.str() != key)
+    return E_FAIL;
+
+  *ppContent = pContent.Detach();
+  return S_OK;
+}
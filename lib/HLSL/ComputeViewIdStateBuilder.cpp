@@ -51,8 +51,9 @@ public:
   using InputsContributingToOutputType =
       DxilViewIdStateData::InputsContributingToOutputType;
 
-  DxilViewIdStateBuilder(DxilViewIdStateData &state, DxilModule *pDxilModule)
-      : m_pModule(pDxilModule),
+  DxilViewIdStateBuilder(DxilViewIdStateData &state, DxilModule *pDxilModule,
+                         ControlDependenceAnalysis &CtrlDepAnalysis)
+      : m_pModule(pDxilModule), m_CtrlDepAnalysis(CtrlDepAnalysis),
         m_NumInputSigScalars(state.m_NumInputSigScalars),
         m_NumOutputSigScalars(state.m_NumOutputSigScalars,
                               DxilViewIdStateData::kNumStreams),
@@ -74,6 +75,7 @@ private:
   static const unsigned kNumStreams = 4;
 
   DxilModule *m_pModule;
+  ControlDependenceAnalysis &m_CtrlDepAnalysis;
 
   unsigned &m_NumInputSigScalars;
   MutableArrayRef<unsigned> m_NumOutputSigScalars;
@@ -122,7 +124,7 @@ private:
   using FunctionReturnSet = std::unordered_set<llvm::ReturnInst *>;
   struct FuncInfo {
     FunctionReturnSet Returns;
-    ControlDependence CtrlDep;
+    const ControlDependence *pCtrlDep = nullptr;
     std::unique_ptr<llvm::DominatorTreeBase<llvm::BasicBlock>> pDomTree;
     void Clear();
   };
@@ -268,7 +270,7 @@ void DxilViewIdStateBuilder::EntryInfo::Clear() {
 
 void DxilViewIdStateBuilder::FuncInfo::Clear() {
   Returns.clear();
-  CtrlDep.Clear();
+  pCtrlDep = nullptr;
   pDomTree.reset();
 }
 
@@ -439,16 +441,11 @@ void DxilViewIdStateBuilder::AnalyzeFunctions(EntryInfo &Entry) {
     pFuncInfo->pDomTree->print(dbgs());
 #endif
 
-    // Compute postdominator relation.
-    DominatorTreeBase<BasicBlock> PDR(true);
-    PDR.recalculate(*F);
+    // Compute postdominator relation and control dependence.
+    pFuncInfo->pCtrlDep = &m_CtrlDepAnalysis.GetControlDependence(F);
 #if DXILVIEWID_DBG
-    PDR.print(dbgs());
-#endif
-    // Compute control dependence.
-    pFuncInfo->CtrlDep.Compute(F, PDR);
-#if DXILVIEWID_DBG
-    pFuncInfo->CtrlDep.print(dbgs());
+    m_CtrlDepAnalysis.GetPostDomRelation(F).print(dbgs());
+    pFuncInfo->pCtrlDep->print(dbgs());
 #endif
   }
 }
@@ -525,8 +522,7 @@ void DxilViewIdStateBuilder::CollectValuesContributingToOutputs(
     BasicBlock *pBB = CI->getParent();
     Function *F = pBB->getParent();
     FuncInfo *pFuncInfo = m_FuncInfo[F].get();
-    const BasicBlockSet &CtrlDepSet = pFuncInfo->CtrlDep.GetCDBlocks(pBB);
-    for (BasicBlock *B : CtrlDepSet) {
+    for (BasicBlock *B : pFuncInfo->pCtrlDep->GetCDBlocks(pBB)) {
       CollectValuesContributingToOutputRec(Entry, B->getTerminator(),
                                            *pContributingInstructions);
     }
@@ -617,8 +613,7 @@ void DxilViewIdStateBuilder::CollectValuesContributingToOutputRec(
 
   // Handle control dependence of this instruction BB.
   FuncInfo *pFuncInfo = FuncInfoIt->second.get();
-  const BasicBlockSet &CtrlDepSet = pFuncInfo->CtrlDep.GetCDBlocks(pBB);
-  for (BasicBlock *B : CtrlDepSet) {
+  for (BasicBlock *B : pFuncInfo->pCtrlDep->GetCDBlocks(pBB)) {
     CollectValuesContributingToOutputRec(Entry, B->getTerminator(),
                                          ContributingInstructions);
   }
@@ -710,8 +705,7 @@ void DxilViewIdStateBuilder::CollectPhiCFValuesContributingToOutputRec(
     // Handle control dependence of this constant argument highest legal
     // "definition" point.
     pBB = pDefDomNode->getBlock();
-    const BasicBlockSet &CtrlDepSet = pFuncInfo->CtrlDep.GetCDBlocks(pBB);
-    for (BasicBlock *B : CtrlDepSet) {
+    for (BasicBlock *B : pFuncInfo->pCtrlDep->GetCDBlocks(pBB)) {
       CollectValuesContributingToOutputRec(Entry, B->getTerminator(),
                                            ContributingInstructions);
     }
@@ -987,6 +981,7 @@ char ComputeViewIdState::ID = 0;
 
 INITIALIZE_PASS_BEGIN(ComputeViewIdState, "viewid-state",
                       "Compute information related to ViewID", true, true)
+INITIALIZE_PASS_DEPENDENCY(ControlDependenceAnalysis)
 INITIALIZE_PASS_END(ComputeViewIdState, "viewid-state",
                     "Compute information related to ViewID", true, true)
 
@@ -997,7 +992,8 @@ bool ComputeViewIdState::runOnModule(Module &M) {
   const ShaderModel *pSM = DxilModule.GetShaderModel();
   if (!pSM->IsCS() && !pSM->IsLib()) {
     DxilViewIdState ViewIdState(&DxilModule);
-    DxilViewIdStateBuilder Builder(ViewIdState, &DxilModule);
+    DxilViewIdStateBuilder Builder(ViewIdState, &DxilModule,
+                                   getAnalysis<ControlDependenceAnalysis>());
     Builder.Compute();
     // Serialize viewidstate.
     ViewIdState.Serialize();
@@ -1013,6 +1009,7 @@ bool ComputeViewIdState::runOnModule(Module &M) {
 }
 
 void ComputeViewIdState::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<ControlDependenceAnalysis>();
   AU.setPreservesAll();
 }
 
@@ -13,26 +13,31 @@
 
 #include "dxc/HLSL/ControlDependence.h"
 #include "dxc/Support/Global.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/IR/CFG.h"
 #include "llvm/Support/Debug.h"
 
 using namespace llvm;
 using namespace hlsl;
 
-const BasicBlockSet &ControlDependence::GetCDBlocks(BasicBlock *pBB) const {
-  auto it = m_ControlDependence.find(pBB);
-  if (it != m_ControlDependence.end())
-    return it->second;
-  else
-    return m_EmptyBBSet;
+ControlDependence::BlockRange
+ControlDependence::GetCDBlocks(BasicBlock *pBB) const {
+  auto it = m_BlockNumbers.find(pBB);
+  const BlockBitSet &CDBlocks = it != m_BlockNumbers.end()
+                                    ? m_ControlDependence[it->second]
+                                    : m_EmptyBBSet;
+  return BlockRange(BlockIterator(m_Blocks, CDBlocks.begin()),
+                    BlockIterator(m_Blocks, CDBlocks.end()));
 }
 
-void ControlDependence::print(raw_ostream &OS) {
+void ControlDependence::print(raw_ostream &OS) const {
   OS << "Control dependence for function '" << m_pFunc->getName() << "'\n";
-  for (auto &it : m_ControlDependence) {
-    BasicBlock *pBB = it.first;
-    OS << "Block " << pBB->getName() << ": { ";
+  for (unsigned iBB = 0; iBB < m_Blocks.size(); iBB++) {
+    if (m_ControlDependence[iBB].empty())
+      continue;
+    OS << "Block " << m_Blocks[iBB]->getName() << ": { ";
     bool bFirst = true;
-    for (BasicBlock *pBB2 : it.second) {
+    for (BasicBlock *pBB2 : GetCDBlocks(m_Blocks[iBB])) {
       if (!bFirst)
         OS << ", ";
       OS << pBB2->getName();
@@ -43,83 +48,113 @@ void ControlDependence::print(raw_ostream &OS) {
   OS << "\n";
 }
 
-void ControlDependence::dump() { print(dbgs()); }
+void ControlDependence::dump() const { print(dbgs()); }
 
 void ControlDependence::Compute(Function *F, PostDomRelationType &PostDomRel) {
   m_pFunc = F;
 
-  // Compute reverse topological order of PDT.
-  BasicBlockVector RevTopOrder;
-  BasicBlockSet VisitedBBs;
+  // Number blocks in post-order of PDT, i.e., reverse topological order.
   for (BasicBlock *pBB : PostDomRel.getRoots()) {
-    ComputeRevTopOrderRec(PostDomRel, pBB, RevTopOrder, VisitedBBs);
+    NumberBlocks(PostDomRel, pBB);
   }
-  DXASSERT_NOMSG(RevTopOrder.size() == VisitedBBs.size());
-
-  // Compute control dependence relation.
-  for (size_t iBB = 0; iBB < RevTopOrder.size(); iBB++) {
-    BasicBlock *x = RevTopOrder[iBB];
-
-    // For each y = pred(x): if ipostdom(y) != x then add "x is control
-    // dependent on y"
-    for (auto itPred = pred_begin(x), endPred = pred_end(x); itPred != endPred;
-         ++itPred) {
-      BasicBlock *y = *itPred; // predecessor of x
-      BasicBlock *pPredIDomBB = GetIPostDom(PostDomRel, y);
-      if (pPredIDomBB != x) {
-        m_ControlDependence[x].insert(y);
-      }
+  m_ControlDependence.resize(m_Blocks.size());
+
+  // Compute control dependence relation. Block x is control dependent on
+  // each predecessor y and on each block y some z with ipostdom(z) = x is
+  // control dependent on, unless ipostdom(y) = x. The blocks with
+  // ipostdom(y) = x are exactly the PDT children of x, so this is:
+  //   CDG(x) = (pred(x) U CDG(children(x))) - children(x)
+  // Children come first in the numbering, so one pass suffices.
+  for (unsigned x = 0; x < m_Blocks.size(); x++) {
+    BlockBitSet &CDx = m_ControlDependence[x];
+    BasicBlock *pBB = m_Blocks[x];
+    for (auto itPred = pred_begin(pBB), endPred = pred_end(pBB);
+         itPred != endPred; ++itPred) {
+      CDx.set(GetBlockNumber(*itPred));
     }
 
-    // For all z such that ipostdom(z) = x
-    for (DomTreeNode *child : PostDomRel.getNode(x)->getChildren()) {
-      BasicBlock *z = child->getBlock();
-
-      auto it = m_ControlDependence.find(z);
-      if (it == m_ControlDependence.end())
-        continue;
-
-      // For all y in CDG(z)
-      for (BasicBlock *y : it->second) {
-        // if ipostdom(y) != x then add "x is control dependent on y"
-        BasicBlock *pPredIDomBB = GetIPostDom(PostDomRel, y);
-        if (pPredIDomBB != x) {
-          m_ControlDependence[x].insert(y);
-        }
-      }
+    DomTreeNode *pNode = PostDomRel.getNode(pBB);
+    for (DomTreeNode *pChild : *pNode) {
+      CDx |= m_ControlDependence[GetBlockNumber(pChild->getBlock())];
+    }
+    for (DomTreeNode *pChild : *pNode) {
+      CDx.reset(GetBlockNumber(pChild->getBlock()));
     }
   }
 }
 
 void ControlDependence::Clear() {
   m_pFunc = nullptr;
+  m_Blocks.clear();
+  m_BlockNumbers.clear();
   m_ControlDependence.clear();
-  m_EmptyBBSet.clear();
 }
 
-BasicBlock *ControlDependence::GetIPostDom(PostDomRelationType &PostDomRel,
-                                           BasicBlock *pBB) {
-  auto *pPDTNode = PostDomRel.getNode(pBB);
-  auto *pIDomNode = pPDTNode->getIDom();
-  BasicBlock *pIDomBB = pIDomNode != nullptr ? pIDomNode->getBlock() : nullptr;
-  return pIDomBB;
+unsigned ControlDependence::GetBlockNumber(BasicBlock *pBB) const {
+  auto it = m_BlockNumbers.find(pBB);
+  DXASSERT(it != m_BlockNumbers.end(), "else block is not in the PDT");
+  return it->second;
 }
 
-void ControlDependence::ComputeRevTopOrderRec(PostDomRelationType &PostDomRel,
-                                              BasicBlock *pBB,
-                                              BasicBlockVector &RevTopOrder,
-                                              BasicBlockSet &VisitedBBs) {
-  if (VisitedBBs.find(pBB) != VisitedBBs.end()) {
+// Numbers the post-dominator subtree rooted at pBB in post-order, so every
+// block is numbered after the blocks it post-dominates. Children are visited
+// last to first, and only direct children are walked: expanding all
+// descendants of every node, as DominatorTreeBase::getDescendants does, is
+// quadratic in the tree depth.
+void ControlDependence::NumberBlocks(PostDomRelationType &PostDomRel,
+                                     BasicBlock *pBB) {
+  if (m_BlockNumbers.count(pBB))
     return;
+
+  // Each entry holds a node and the number of its children left to visit.
+  SmallVector<std::pair<DomTreeNode *, unsigned>, 32> Stack;
+  DomTreeNode *pRoot = PostDomRel.getNode(pBB);
+  Stack.emplace_back(pRoot, pRoot->getNumChildren());
+  while (!Stack.empty()) {
+    DomTreeNode *pNode = Stack.back().first;
+    unsigned &NumChildrenLeft = Stack.back().second;
+    if (NumChildrenLeft == 0) {
+      m_BlockNumbers[pNode->getBlock()] = m_Blocks.size();
+      m_Blocks.emplace_back(pNode->getBlock());
+      Stack.pop_back();
+      continue;
+    }
+    DomTreeNode *pChild = pNode->getChildren()[--NumChildrenLeft];
+    if (!m_BlockNumbers.count(pChild->getBlock()))
+      Stack.emplace_back(pChild, pChild->getNumChildren());
   }
-  VisitedBBs.insert(pBB);
+}
+
+char ControlDependenceAnalysis::ID = 0;
+
+ControlDependenceAnalysis::ControlDependenceAnalysis() : ModulePass(ID) {
+  initializeControlDependenceAnalysisPass(*PassRegistry::getPassRegistry());
+}
 
-  SmallVector<BasicBlock *, 8> Descendants;
-  PostDomRel.getDescendants(pBB, Descendants);
-  for (BasicBlock *pDescBB : Descendants) {
-    if (pDescBB != pBB)
-      ComputeRevTopOrderRec(PostDomRel, pDescBB, RevTopOrder, VisitedBBs);
+ControlDependenceAnalysis::FuncInfo &
+ControlDependenceAnalysis::GetFuncInfo(Function *F) {
+  std::unique_ptr<FuncInfo> &pInfo = m_FuncInfo[F];
+  if (!pInfo) {
+    pInfo = llvm::make_unique<FuncInfo>();
+    pInfo->PostDomRel.recalculate(*F);
   }
+  return *pInfo;
+}
+
+PostDomRelationType &
+ControlDependenceAnalysis::GetPostDomRelation(Function *F) {
+  return GetFuncInfo(F).PostDomRel;
+}
 
-  RevTopOrder.emplace_back(pBB);
+const ControlDependence &
+ControlDependenceAnalysis::GetControlDependence(Function *F) {
+  FuncInfo &Info = GetFuncInfo(F);
+  if (!Info.bCtrlDepComputed) {
+    Info.CtrlDep.Compute(F, Info.PostDomRel);
+    Info.bCtrlDepComputed = true;
+  }
+  return Info.CtrlDep;
 }
+
+INITIALIZE_PASS(ControlDependenceAnalysis, "dxil-control-dependence",
+                "DXIL Control Dependence", true, true)
@@ -13,6 +13,7 @@
 #include "dxc/DXIL/DxilUtil.h"
 #include "dxc/DxilContainer/DxilContainer.h"
 #include "dxc/DxilContainer/DxilContainerAssembler.h"
+#include "dxc/DxilContainer/DxilContainerReader.h"
 #include "dxc/DxilContainer/DxilPipelineStateValidation.h"
 #include "dxc/DxilContainer/DxilRuntimeReflection.h"
 #include "dxc/HLSL/ComputeViewIdState.h"
@@ -311,10 +312,11 @@ HRESULT STDMETHODCALLTYPE DxcOptimizer::RunOptimizer(
       // - RootSignature from RTS0
       // - ViewID and I/O dependency data from PSV0
       // - Resource names and types/annotations from STAT
+      DxilPartIndex PartIndex(pContainerHeader);
 
       // RDAT
       if (const DxilPartHeader *pPartHeader =
-              GetDxilPartByType(pContainerHeader, DFCC_RuntimeData)) {
+              PartIndex.GetPartByType(DFCC_RuntimeData)) {
         DxilModule &DM = M->GetOrCreateDxilModule();
         RDAT::DxilRuntimeData rdat(GetDxilPartData(pPartHeader),
                                    pPartHeader->PartSize);
@@ -329,7 +331,7 @@ HRESULT STDMETHODCALLTYPE DxcOptimizer::RunOptimizer(
 
       // RST0
       if (const DxilPartHeader *pPartHeader =
-              GetDxilPartByType(pContainerHeader, DFCC_RootSignature)) {
+              PartIndex.GetPartByType(DFCC_RootSignature)) {
         DxilModule &DM = M->GetOrCreateDxilModule();
         const uint8_t *pPartData =
             (const uint8_t *)GetDxilPartData(pPartHeader);
@@ -339,8 +341,8 @@ HRESULT STDMETHODCALLTYPE DxcOptimizer::RunOptimizer(
       }
 
       // PSV0
-      if (const DxilPartHeader *pPartHeader = GetDxilPartByType(
-              pContainerHeader, DFCC_PipelineStateValidation)) {
+      if (const DxilPartHeader *pPartHeader =
+              PartIndex.GetPartByType(DFCC_PipelineStateValidation)) {
         DxilModule &DM = M->GetOrCreateDxilModule();
         std::vector<unsigned int> &viewState = DM.GetSerializedViewIdState();
         if (viewState.empty()) {
@@ -358,7 +360,7 @@ HRESULT STDMETHODCALLTYPE DxcOptimizer::RunOptimizer(
 
       // STAT
       if (const DxilPartHeader *pPartHeader =
-              GetDxilPartByType(pContainerHeader, DFCC_ShaderStatistics)) {
+              PartIndex.GetPartByType(DFCC_ShaderStatistics)) {
         const DxilProgramHeader *pReflProgramHeader =
             reinterpret_cast<const DxilProgramHeader *>(
                 GetDxilPartData(pPartHeader));
@@ -18,6 +18,8 @@
 #include "dxc/DXIL/DxilShaderModel.h"
 #include "dxc/DXIL/DxilUtil.h"
 #include "dxc/DxilContainer/DxilContainer.h"
+#include "dxc/DxilContainer/DxilContainerReader.h"
+#include "dxc/DxilContainer/DxilReflectionDatabase.h"
 #include "dxc/HLSL/HLMatrixType.h"
 #include "dxc/Support/FileIOHelper.h"
 #include "dxc/Support/Global.h"
@@ -75,6 +77,7 @@ private:
   CComPtr<IDxcBlob> m_container;
   const DxilContainerHeader *m_pHeader = nullptr;
   uint32_t m_headerLen = 0;
+  DxilPartIndex m_PartIndex;
   bool IsLoaded() const { return m_pHeader != nullptr; }
 
 public:
@@ -398,6 +401,7 @@ HRESULT DxilContainerReflection::Load(IDxcBlob *pContainer) {
     m_container.Release();
     m_pHeader = nullptr;
     m_headerLen = 0;
+    m_PartIndex.Clear();
     return S_OK;
   }
 
@@ -426,6 +430,7 @@ HRESULT DxilContainerReflection::Load(IDxcBlob *pContainer) {
   m_container = pContainer;
   m_headerLen = bufLen;
   m_pHeader = pHeader;
+  m_PartIndex.Init(pHeader);
 
   return S_OK;
 }
@@ -478,11 +483,10 @@ HRESULT DxilContainerReflection::FindFirstPartKind(UINT32 kind,
   *pResult = 0;
   if (!IsLoaded())
     return E_NOT_VALID_STATE;
-  DxilPartIterator it =
-      std::find_if(begin(m_pHeader), end(m_pHeader), DxilPartIsType(kind));
-  if (it == end(m_pHeader))
+  uint32_t idx = m_PartIndex.FindFirstPartIndex(kind);
+  if (idx == DXIL_CONTAINER_BLOB_NOT_FOUND)
     return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
-  *pResult = it.index;
+  *pResult = idx;
   return S_OK;
 }
 
@@ -2289,19 +2293,22 @@ HRESULT DxilModuleReflection::LoadProgramHeader(
     uint32_t bitcodeLength;
     GetDxilProgramBitcode((const DxilProgramHeader *)pProgramHeader, &pBitcode,
                           &bitcodeLength);
-    std::unique_ptr<MemoryBuffer> pMemBuffer =
-        MemoryBuffer::getMemBufferCopy(StringRef(pBitcode, bitcodeLength));
     bool bBitcodeLoadError = false;
     auto errorHandler = [&bBitcodeLoadError](const DiagnosticInfo &diagInfo) {
       bBitcodeLoadError |= diagInfo.getSeverity() == DS_Error;
     };
 #if 0 // We materialize eagerly, because we'll need to walk instructions to look
       // for usage information.
+    std::unique_ptr<MemoryBuffer> pMemBuffer =
+        MemoryBuffer::getMemBufferCopy(StringRef(pBitcode, bitcodeLength));
     ErrorOr<std::unique_ptr<Module>> mod =
         getLazyBitcodeModule(std::move(pMemBuffer), Context, errorHandler);
 #else
-    ErrorOr<std::unique_ptr<Module>> mod =
-        parseBitcodeFile(pMemBuffer->getMemBufferRef(), Context, errorHandler);
+    // The module is fully materialized before parseBitcodeFile returns, so the
+    // bitcode can be read in place from the container.
+    ErrorOr<std::unique_ptr<Module>> mod = parseBitcodeFile(
+        MemoryBufferRef(StringRef(pBitcode, bitcodeLength), ""), Context,
+        errorHandler);
 #endif
     if (!mod || bBitcodeLoadError) {
       return E_INVALIDARG;
@@ -3092,3 +3099,257 @@ DxilLibraryReflection::GetFunctionByIndex(INT FunctionIndex) {
     return &g_InvalidFunction;
   return m_FunctionVector[FunctionIndex];
 }
+
+// Reflection database
+
+namespace {
+
+// Appends Str to the string buffer of the entry and returns its offset.
+uint32_t AddDatabaseString(DxilReflectionDatabaseEntry &Entry, LPCSTR Str) {
+  if (!Str || !*Str)
+    return 0;
+  uint32_t Offset = (uint32_t)Entry.Strings.size();
+  Entry.Strings.append(Str);
+  Entry.Strings.push_back('\0');
+  return Offset;
+}
+
+void AddDatabaseSignature(DxilReflectionDatabaseEntry &Entry,
+                          DxilShaderReflection &Reflection,
+                          HRESULT (STDMETHODCALLTYPE DxilShaderReflection::*
+                                       GetParameterDesc)(
+                              UINT, D3D12_SIGNATURE_PARAMETER_DESC *),
+                          UINT Count) {
+  for (UINT i = 0; i < Count; ++i) {
+    D3D12_SIGNATURE_PARAMETER_DESC Desc;
+    IFT((Reflection.*GetParameterDesc)(i, &Desc));
+    DxilReflectionDatabaseSignatureElement Element = {};
+    Element.SemanticName = AddDatabaseString(Entry, Desc.SemanticName);
+    Element.SemanticIndex = Desc.SemanticIndex;
+    Element.Register = Desc.Register;
+    Element.SystemValueType = Desc.SystemValueType;
+    Element.ComponentType = Desc.ComponentType;
+    Element.Mask = Desc.Mask;
+    Element.ReadWriteMask = Desc.ReadWriteMask;
+    Element.Stream = Desc.Stream;
+    Element.MinPrecision = Desc.MinPrecision;
+    Entry.SignatureElements.push_back(Element);
+  }
+}
+
+// Records the resources and constant buffers common to shaders and libraries.
+void AddDatabaseModule(DxilReflectionDatabaseEntry &Entry,
+                       DxilModuleReflection &Reflection) {
+  for (UINT i = 0; i < (UINT)Reflection.m_Resources.size(); ++i) {
+    D3D12_SHADER_INPUT_BIND_DESC Desc;
+    IFT(Reflection._GetResourceBindingDesc(i, &Desc));
+    DxilReflectionDatabaseResource Resource = {};
+    Resource.Name = AddDatabaseString(Entry, Desc.Name);
+    Resource.Type = Desc.Type;
+    Resource.BindPoint = Desc.BindPoint;
+    Resource.BindCount = Desc.BindCount;
+    Resource.Flags = Desc.uFlags;
+    Resource.ReturnType = Desc.ReturnType;
+    Resource.Dimension = Desc.Dimension;
+    Resource.NumSamples = Desc.NumSamples;
+    Resource.Space = Desc.Space;
+    Entry.Resources.push_back(Resource);
+  }
+  Entry.Shader.ResourceCount = (uint32_t)Entry.Resources.size();
+
+  for (UINT i = 0; i < (UINT)Reflection.m_CBs.size(); ++i) {
+    ID3D12ShaderReflectionConstantBuffer *pCB =
+        Reflection._GetConstantBufferByIndex(i);
+    D3D12_SHADER_BUFFER_DESC Desc;
+    IFT(pCB->GetDesc(&Desc));
+    DxilReflectionDatabaseConstantBuffer CB = {};
+    CB.Name = AddDatabaseString(Entry, Desc.Name);
+    CB.Type = Desc.Type;
+    CB.Size = Desc.Size;
+    CB.Flags = Desc.uFlags;
+    CB.FirstVariable = (uint32_t)Entry.Variables.size();
+    CB.VariableCount = Desc.Variables;
+    for (UINT v = 0; v < Desc.Variables; ++v) {
+      ID3D12ShaderReflectionVariable *pVar = pCB->GetVariableByIndex(v);
+      D3D12_SHADER_VARIABLE_DESC VarDesc;
+      D3D12_SHADER_TYPE_DESC TypeDesc;
+      IFT(pVar->GetDesc(&VarDesc));
+      IFT(pVar->GetType()->GetDesc(&TypeDesc));
+      DxilReflectionDatabaseVariable Var = {};
+      Var.Name = AddDatabaseString(Entry, VarDesc.Name);
+      Var.StartOffset = VarDesc.StartOffset;
+      Var.Size = VarDesc.Size;
+      Var.Flags = VarDesc.uFlags;
+      Var.TypeName = AddDatabaseString(Entry, TypeDesc.Name);
+      Var.Class = TypeDesc.Class;
+      Var.Type = TypeDesc.Type;
+      Var.Rows = TypeDesc.Rows;
+      Var.Columns = TypeDesc.Columns;
+      Var.Elements = TypeDesc.Elements;
+      Var.Members = TypeDesc.Members;
+      Entry.Variables.push_back(Var);
+    }
+    Entry.ConstantBuffers.push_back(CB);
+  }
+  Entry.Shader.ConstantBufferCount = (uint32_t)Entry.ConstantBuffers.size();
+}
+
+template <typename T>
+void AppendDatabaseTable(std::vector<char> &Database,
+                         DxilReflectionDatabaseTableDesc &Desc,
+                         const std::vector<T> &Records) {
+  Desc.Offset = (uint32_t)Database.size();
+  Desc.RecordCount = (uint32_t)Records.size();
+  Desc.RecordSize = sizeof(T);
+  const char *pData = reinterpret_cast<const char *>(Records.data());
+  Database.insert(Database.end(), pData, pData + Records.size() * sizeof(T));
+}
+
+} // namespace
+
+namespace hlsl {
+
+HRESULT CreateDxilReflectionDatabaseEntry(const void *pContainer, size_t size,
+                                          DxilReflectionDatabaseEntry &Entry) {
+  const DxilContainerHeader *pHeader = IsDxilContainerLike(pContainer, size);
+  if (!pHeader || !IsValidDxilContainer(pHeader, size))
+    return E_INVALIDARG;
+
+  // Same part preference as IDxcUtils::CreateReflection.
+  const DxilPartHeader *pModulePart =
+      GetDxilPartByType(pHeader, DFCC_ShaderStatistics);
+  if (!pModulePart)
+    pModulePart = GetDxilPartByType(pHeader, DFCC_ShaderDebugInfoDXIL);
+  if (!pModulePart)
+    pModulePart = GetDxilPartByType(pHeader, DFCC_DXIL);
+  if (!pModulePart)
+    return DXC_E_MISSING_PART;
+  const DxilPartHeader *pRDATPart =
+      GetDxilPartByType(pHeader, DFCC_RuntimeData);
+
+  const DxilProgramHeader *pProgramHeader =
+      reinterpret_cast<const DxilProgramHeader *>(GetDxilPartData(pModulePart));
+  if (!IsValidDxilProgramHeader(pProgramHeader, pModulePart->PartSize))
+    return E_INVALIDARG;
+  if (pModulePart->PartSize - pProgramHeader->BitcodeHeader.BitcodeOffset < 4)
+    return DXC_E_MISSING_PART;
+  DXIL::ShaderKind SK = GetVersionShaderType(pProgramHeader->ProgramVersion);
+  if (!(SK < DXIL::ShaderKind::Invalid))
+    return E_INVALIDARG;
+
+  try {
+    Entry.Shader.ProgramVersion = pProgramHeader->ProgramVersion;
+
+    // The reflection objects are used directly rather than through COM
+    // references, and only live until their records are copied out.
+    if (SK == DXIL::ShaderKind::Library) {
+      DxilLibraryReflection Reflection(DxcGetThreadMallocNoRef());
+      IFR(Reflection.Load(pProgramHeader, pRDATPart));
+      AddDatabaseModule(Entry, Reflection);
+      return S_OK;
+    }
+
+    DxilShaderReflection Reflection(DxcGetThreadMallocNoRef());
+    Reflection.SetPublicAPI(PublicAPI::D3D12);
+    IFR(Reflection.Load(pProgramHeader, pRDATPart));
+    AddDatabaseModule(Entry, Reflection);
+
+    D3D12_SHADER_DESC Desc;
+    IFR(Reflection.GetDesc(&Desc));
+    Reflection.GetThreadGroupSize(&Entry.Shader.ThreadGroupSize[0],
+                                  &Entry.Shader.ThreadGroupSize[1],
+                                  &Entry.Shader.ThreadGroupSize[2]);
+    AddDatabaseSignature(Entry, Reflection,
+                         &DxilShaderReflection::GetInputParameterDesc,
+                         Desc.InputParameters);
+    AddDatabaseSignature(Entry, Reflection,
+                         &DxilShaderReflection::GetOutputParameterDesc,
+                         Desc.OutputParameters);
+    AddDatabaseSignature(Entry, Reflection,
+                         &DxilShaderReflection::GetPatchConstantParameterDesc,
+                         Desc.PatchConstantParameters);
+    Entry.Shader.InputCount = Desc.InputParameters;
+    Entry.Shader.OutputCount = Desc.OutputParameters;
+    Entry.Shader.PatchConstantCount = Desc.PatchConstantParameters;
+    return S_OK;
+  }
+  CATCH_CPP_RETURN_HRESULT();
+}
+
+void WriteDxilReflectionDatabase(
+    const std::vector<DxilReflectionDatabaseEntry> &Entries,
+    std::vector<char> &Database) {
+  std::vector<DxilReflectionDatabaseShader> Shaders;
+  std::vector<DxilReflectionDatabaseResource> Resources;
+  std::vector<DxilReflectionDatabaseConstantBuffer> ConstantBuffers;
+  std::vector<DxilReflectionDatabaseVariable> Variables;
+  std::vector<DxilReflectionDatabaseSignatureElement> SignatureElements;
+  std::vector<char> Strings(1, '\0');
+
+  // Rebase the indices and string offsets of each entry onto the tables.
+  for (const DxilReflectionDatabaseEntry &Entry : Entries) {
+    // Skip the empty string at the start of each entry's buffer.
+    const uint32_t StringBase = (uint32_t)Strings.size() - 1;
+    auto Rebase = [StringBase](uint32_t Offset) {
+      return Offset ? Offset + StringBase : 0;
+    };
+    Strings.insert(Strings.end(), Entry.Strings.begin() + 1,
+                   Entry.Strings.end());
+
+    DxilReflectionDatabaseShader Shader = Entry.Shader;
+    Shader.FirstResource = (uint32_t)Resources.size();
+    Shader.FirstConstantBuffer = (uint32_t)ConstantBuffers.size();
+    Shader.FirstSignatureElement = (uint32_t)SignatureElements.size();
+    Shaders.push_back(Shader);
+
+    for (DxilReflectionDatabaseResource Resource : Entry.Resources) {
+      Resource.Name = Rebase(Resource.Name);
+      Resources.push_back(Resource);
+    }
+    const uint32_t VariableBase = (uint32_t)Variables.size();
+    for (DxilReflectionDatabaseConstantBuffer CB : Entry.ConstantBuffers) {
+      CB.Name = Rebase(CB.Name);
+      CB.FirstVariable += VariableBase;
+      ConstantBuffers.push_back(CB);
+    }
+    for (DxilReflectionDatabaseVariable Var : Entry.Variables) {
+      Var.Name = Rebase(Var.Name);
+      Var.TypeName = Rebase(Var.TypeName);
+      Variables.push_back(Var);
+    }
+    for (DxilReflectionDatabaseSignatureElement Element :
+         Entry.SignatureElements) {
+      Element.SemanticName = Rebase(Element.SemanticName);
+      SignatureElements.push_back(Element);
+    }
+  }
+
+  DxilReflectionDatabaseHeader Header = {};
+  Header.Version = DxilReflectionDatabaseVersion;
+  Header.TableCount = (uint32_t)DxilReflectionDatabaseTable::Count;
+  Database.assign(sizeof(Header), 0);
+  auto TableDesc = [&Header](DxilReflectionDatabaseTable Table)
+      -> DxilReflectionDatabaseTableDesc & {
+    return Header.Tables[(uint32_t)Table];
+  };
+  AppendDatabaseTable(Database, TableDesc(DxilReflectionDatabaseTable::Shaders),
+                      Shaders);
+  AppendDatabaseTable(Database,
+                      TableDesc(DxilReflectionDatabaseTable::Resources),
+                      Resources);
+  AppendDatabaseTable(Database,
+                      TableDesc(DxilReflectionDatabaseTable::ConstantBuffers),
+                      ConstantBuffers);
+  AppendDatabaseTable(Database,
+                      TableDesc(DxilReflectionDatabaseTable::Variables),
+                      Variables);
+  AppendDatabaseTable(Database,
+                      TableDesc(DxilReflectionDatabaseTable::SignatureElements),
+                      SignatureElements);
+  AppendDatabaseTable(Database,
+                      TableDesc(DxilReflectionDatabaseTable::StringBuffer),
+                      Strings);
+  memcpy(Database.data(), &Header, sizeof(Header));
+}
+
+} // namespace hlsl
@@ -29,15 +29,6 @@ namespace {
 
 typedef std::unordered_set<Value *> ValueSet;
 
-struct FuncInfo {
-  ControlDependence CtrlDep;
-  std::unique_ptr<llvm::DominatorTreeBase<llvm::BasicBlock>> pPostDom;
-  void Init(Function *F);
-  void Clear();
-};
-typedef std::unordered_map<llvm::Function *, std::unique_ptr<FuncInfo>>
-    FuncInfoMap;
-
 class DxilPrecisePropagatePass : public ModulePass {
 public:
   static char ID; // Pass identification, replacement for typeid
@@ -45,8 +36,14 @@ public:
 
   StringRef getPassName() const override { return "DXIL Precise Propagate"; }
 
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<ControlDependenceAnalysis>();
+    AU.setPreservesCFG();
+  }
+
   bool runOnModule(Module &M) override {
     m_pDM = &(M.GetOrCreateDxilModule());
+    m_pCtrlDepAnalysis = &getAnalysis<ControlDependenceAnalysis>();
     std::vector<Function *> deadList;
     for (Function &F : M.functions()) {
       if (HLModule::HasPreciseAttribute(&F)) {
@@ -72,19 +69,16 @@ private:
                             ValueSet &processedGEPs);
   void PropagateOnPointerUsedInCall(Value *Ptr, CallInst *CI);
 
-  void PropagateCtrlDep(FuncInfo &FI, BasicBlock *BB);
   void PropagateCtrlDep(BasicBlock *BB);
   void PropagateCtrlDep(Instruction *I);
 
   // Add to m_ProcessedSet, return true if already in set.
   bool Processed(Value *V) { return !m_ProcessedSet.insert(V).second; }
 
-  FuncInfo &GetFuncInfo(Function *F);
-
   DxilModule *m_pDM;
+  ControlDependenceAnalysis *m_pCtrlDepAnalysis;
   std::vector<Value *> m_WorkList;
   ValueSet m_ProcessedSet;
-  FuncInfoMap m_FuncInfo;
 };
 
 char DxilPrecisePropagatePass::ID = 0;
@@ -146,10 +140,9 @@ void DxilPrecisePropagatePass::Propagate(Instruction *I) {
 
   if (PHINode *Phi = dyn_cast<PHINode>(I)) {
     // Use pred for control dependence when constant (for now)
-    FuncInfo &FI = GetFuncInfo(I->getParent()->getParent());
     for (unsigned i = 0; i < Phi->getNumIncomingValues(); i++) {
       if (isa<Constant>(Phi->getIncomingValue(i)))
-        PropagateCtrlDep(FI, Phi->getIncomingBlock(i));
+        PropagateCtrlDep(Phi->getIncomingBlock(i));
     }
   }
 }
@@ -328,40 +321,16 @@ void DxilPrecisePropagatePass::PropagateOnPointerUsedInCall(Value *Ptr,
   }
 }
 
-void FuncInfo::Init(Function *F) {
-  if (!pPostDom) {
-    pPostDom = make_unique<DominatorTreeBase<BasicBlock>>(true);
-    pPostDom->recalculate(*F);
-    CtrlDep.Compute(F, *pPostDom);
-  }
-}
-void FuncInfo::Clear() {
-  CtrlDep.Clear();
-  pPostDom.reset();
-}
-FuncInfo &DxilPrecisePropagatePass::GetFuncInfo(Function *F) {
-  auto &FI = m_FuncInfo[F];
-  if (!FI) {
-    FI = make_unique<FuncInfo>();
-    FI->Init(F);
-  }
-  return *FI.get();
-}
-
-void DxilPrecisePropagatePass::PropagateCtrlDep(FuncInfo &FI, BasicBlock *BB) {
+void DxilPrecisePropagatePass::PropagateCtrlDep(BasicBlock *BB) {
   if (Processed(BB))
     return;
-  const BasicBlockSet &CtrlDepSet = FI.CtrlDep.GetCDBlocks(BB);
-  for (BasicBlock *B : CtrlDepSet) {
+  const ControlDependence &CtrlDep =
+      m_pCtrlDepAnalysis->GetControlDependence(BB->getParent());
+  for (BasicBlock *B : CtrlDep.GetCDBlocks(BB)) {
     AddToWorkList(B->getTerminator());
   }
 }
 
-void DxilPrecisePropagatePass::PropagateCtrlDep(BasicBlock *BB) {
-  FuncInfo &FI = GetFuncInfo(BB->getParent());
-  PropagateCtrlDep(FI, BB);
-}
-
 void DxilPrecisePropagatePass::PropagateCtrlDep(Instruction *I) {
   PropagateCtrlDep(I->getParent());
 }
@@ -370,5 +339,8 @@ ModulePass *llvm::createDxilPrecisePropagatePass() {
   return new DxilPrecisePropagatePass();
 }
 
-INITIALIZE_PASS(DxilPrecisePropagatePass, "hlsl-dxil-precise",
-                "DXIL precise attribute propagate", false, false)
+INITIALIZE_PASS_BEGIN(DxilPrecisePropagatePass, "hlsl-dxil-precise",
+                      "DXIL precise attribute propagate", false, false)
+INITIALIZE_PASS_DEPENDENCY(ControlDependenceAnalysis)
+INITIALIZE_PASS_END(DxilPrecisePropagatePass, "hlsl-dxil-precise",
+                    "DXIL precise attribute propagate", false, false)
@@ -17,6 +17,7 @@
 #include "dxc/DXIL/DxilOperations.h"
 #include "dxc/DXIL/DxilTypeSystem.h"
 #include "dxc/DXIL/DxilUtil.h"
+#include "dxc/HLSL/ControlDependence.h"
 #include "dxc/HLSL/DxilGenerationPass.h"
 #include "dxc/HLSL/DxilPoisonValues.h"
 #include "dxc/HLSL/HLOperations.h"
@@ -28,7 +29,6 @@
 #include "llvm/Analysis/AssumptionCache.h"
 #include "llvm/Analysis/DxilValueCache.h"
 #include "llvm/Analysis/LoopInfo.h"
-#include "llvm/Analysis/PostDominators.h"
 #include "llvm/IR/DIBuilder.h"
 #include "llvm/IR/DebugInfo.h"
 #include "llvm/IR/GetElementPtrTypeIterator.h"
@@ -140,6 +140,10 @@ public:
     return "Remove all unused function except entry from DxilModule";
   }
 
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.setPreservesCFG();
+  }
+
   bool runOnModule(Module &M) override {
     if (M.HasDxilModule()) {
       DxilModule &DM = M.GetDxilModule();
@@ -1538,6 +1542,11 @@ public:
     return "HLSL DXIL wave sensitiveity validation";
   }
 
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<ControlDependenceAnalysis>();
+    AU.setPreservesAll();
+  }
+
   bool runOnModule(Module &M) override {
     // Only check ps and lib profile.
     DxilModule &DM = M.GetDxilModule();
@@ -1608,10 +1617,10 @@ public:
       if (localGradientArgs.empty())
         continue;
 
-      PostDominatorTree PDT;
-      PDT.runOnFunction(F);
       std::unique_ptr<WaveSensitivityAnalysis> WaveVal(
-          WaveSensitivityAnalysis::create(PDT));
+          WaveSensitivityAnalysis::create(
+              getAnalysis<ControlDependenceAnalysis>().GetPostDomRelation(
+                  &F)));
 
       WaveVal->Analyze(&F);
       for (Instruction *gradArg : localGradientArgs) {
@@ -1634,8 +1643,13 @@ ModulePass *llvm::createDxilValidateWaveSensitivityPass() {
   return new DxilValidateWaveSensitivity();
 }
 
-INITIALIZE_PASS(DxilValidateWaveSensitivity, "hlsl-validate-wave-sensitivity",
-                "HLSL DXIL wave sensitiveity validation", false, false)
+INITIALIZE_PASS_BEGIN(DxilValidateWaveSensitivity,
+                      "hlsl-validate-wave-sensitivity",
+                      "HLSL DXIL wave sensitiveity validation", false, false)
+INITIALIZE_PASS_DEPENDENCY(ControlDependenceAnalysis)
+INITIALIZE_PASS_END(DxilValidateWaveSensitivity,
+                    "hlsl-validate-wave-sensitivity",
+                    "HLSL DXIL wave sensitiveity validation", false, false)
 
 namespace {
 
@@ -94,6 +94,11 @@ class ValueTable {
 
   uint32_t nextValueNumber = 1;
 
+  // Whether no memory write precedes the instructions currently being
+  // numbered, since the point where the caller established a common memory
+  // state. Only then may read-only dxil operations be numbered by value.
+  bool memoryUnchanged = false;
+
   Expression createExpr(Instruction *I);
   Expression createCmpExpr(unsigned Opcode, CmpInst::Predicate Predicate,
                            Value *LHS, Value *RHS);
@@ -117,6 +122,7 @@ public:
   void clear();
   void erase(Value *v);
   void setDomTree(DominatorTree *D) { DT = D; }
+  void setMemoryUnchanged(bool Unchanged) { memoryUnchanged = Unchanged; }
   uint32_t getNextUnusedValueNumber() { return nextValueNumber; }
   void verifyRemoved(const Value *) const;
 };
@@ -250,40 +256,49 @@ void ValueTable::add(Value *V, uint32_t num) {
 uint32_t ValueTable::lookupOrAddCall(CallInst *C) {
   Function *F = C->getCalledFunction();
   bool bSafe = false;
-  if (F) {
-    if (F->hasFnAttribute(Attribute::ReadNone)) {
+  if (F && hlsl::OP::IsDxilOpFunc(F)) {
+    // Use the opcode property rather than the function attributes, which may
+    // have been dropped or merged.
+    DXIL::OpCode Opcode = hlsl::OP::GetDxilOpFuncCallInst(C);
+    switch (hlsl::OP::GetMemAccessAttr(Opcode)) {
+    case Attribute::ReadNone:
       bSafe = true;
-    } else if (F->hasFnAttribute(Attribute::ReadOnly)) {
-      if (hlsl::OP::IsDxilOpFunc(F)) {
-        DXIL::OpCode Opcode = hlsl::OP::GetDxilOpFuncCallInst(C);
-        switch (Opcode) {
-        default:
-          break;
-          // TODO: make buffer/texture load on srv safe.
-        case DXIL::OpCode::CreateHandleForLib:
-        case DXIL::OpCode::AnnotateHandle:
-        case DXIL::OpCode::CBufferLoad:
-        case DXIL::OpCode::CBufferLoadLegacy:
-        case DXIL::OpCode::Sample:
-        case DXIL::OpCode::SampleBias:
-        case DXIL::OpCode::SampleCmp:
-        case DXIL::OpCode::SampleCmpLevel:
-        case DXIL::OpCode::SampleCmpLevelZero:
-        case DXIL::OpCode::SampleGrad:
-        case DXIL::OpCode::CheckAccessFullyMapped:
-        case DXIL::OpCode::GetDimensions:
-        case DXIL::OpCode::TextureLoad:
-        case DXIL::OpCode::TextureGather:
-        case DXIL::OpCode::TextureGatherCmp:
-        case DXIL::OpCode::Texture2DMSGetSamplePosition:
-        case DXIL::OpCode::RenderTargetGetSampleCount:
-        case DXIL::OpCode::RenderTargetGetSamplePosition:
-        case DXIL::OpCode::CalculateLOD:
-          bSafe = true;
-          break;
-        }
+      break;
+    case Attribute::ReadOnly:
+      switch (Opcode) {
+      default:
+        // Other reads, such as buffer loads, may observe writes to the same
+        // resource, so they only match when memory hasn't changed in between.
+        bSafe = memoryUnchanged;
+        break;
+      case DXIL::OpCode::CreateHandleForLib:
+      case DXIL::OpCode::AnnotateHandle:
+      case DXIL::OpCode::CBufferLoad:
+      case DXIL::OpCode::CBufferLoadLegacy:
+      case DXIL::OpCode::Sample:
+      case DXIL::OpCode::SampleBias:
+      case DXIL::OpCode::SampleCmp:
+      case DXIL::OpCode::SampleCmpLevel:
+      case DXIL::OpCode::SampleCmpLevelZero:
+      case DXIL::OpCode::SampleGrad:
+      case DXIL::OpCode::CheckAccessFullyMapped:
+      case DXIL::OpCode::GetDimensions:
+      case DXIL::OpCode::TextureLoad:
+      case DXIL::OpCode::TextureGather:
+      case DXIL::OpCode::TextureGatherCmp:
+      case DXIL::OpCode::Texture2DMSGetSamplePosition:
+      case DXIL::OpCode::RenderTargetGetSampleCount:
+      case DXIL::OpCode::RenderTargetGetSamplePosition:
+      case DXIL::OpCode::CalculateLOD:
+        bSafe = true;
+        break;
       }
+      break;
+    default:
+      break;
     }
+  } else if (F && F->hasFnAttribute(Attribute::ReadNone)) {
+    bSafe = true;
   }
   if (bSafe) {
     Expression exp = createExpr(C);
@@ -475,17 +490,26 @@ bool HasOnePred(BasicBlock *BB) {
 bool DxilSimpleGVNHoist::tryToHoist(BasicBlock *BB, BasicBlock *Succ0,
                                     BasicBlock *Succ1) {
   // ValueNumber Succ0 and Succ1.
+  // BB is the only predecessor of both, so memory is the same on entry to
+  // either successor, and reads that precede any write in their block can be
+  // matched against each other.
   ValueTable VT;
   DenseMap<uint32_t, SmallVector<Instruction *, 2>> VNtoInsts;
+  VT.setMemoryUnchanged(true);
   for (Instruction &I : *Succ0) {
     uint32_t V = VT.lookupOrAdd(&I);
     VNtoInsts[V].emplace_back(&I);
+    if (I.mayWriteToMemory())
+      VT.setMemoryUnchanged(false);
   }
 
   std::vector<uint32_t> HoistCandidateVN;
 
+  VT.setMemoryUnchanged(true);
   for (Instruction &I : *Succ1) {
     uint32_t V = VT.lookupOrAdd(&I);
+    if (I.mayWriteToMemory())
+      VT.setMemoryUnchanged(false);
     if (!VNtoInsts.count(V))
       continue;
     VNtoInsts[V].emplace_back(&I);
@@ -22,6 +22,8 @@
 #include "dxc/HlslIntrinsicOp.h"
 #include "dxc/Support/Global.h"
 
+#include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/DIBuilder.h"
 #include "llvm/IR/DebugInfo.h"
@@ -311,11 +313,29 @@ void HLMatrixLowerPass::deleteDeadInsts() {
 
 // Find all instructions consuming or producing matrices,
 // directly or through pointers/arrays.
+// Instructions are collected in reverse post-order so that, as far as the CFG
+// allows, a matrix producer is lowered before its consumers. The consumers then
+// find the producer's vec-to-mat stub and unwrap it, rather than requiring a
+// mat-to-vec stub of their own which is only resolved later.
 void HLMatrixLowerPass::getMatrixAllocasAndOtherInsts(
     Function &Func, std::vector<AllocaInst *> &MatAllocas,
     std::vector<Instruction *> &MatInsts) {
-  for (BasicBlock &BasicBlock : Func) {
-    for (Instruction &Inst : BasicBlock) {
+  std::vector<BasicBlock *> Blocks;
+  Blocks.reserve(Func.size());
+  ReversePostOrderTraversal<Function *> RPOT(&Func);
+  Blocks.insert(Blocks.end(), RPOT.begin(), RPOT.end());
+  if (Blocks.size() != Func.size()) {
+    // Unreachable blocks still need to be lowered, append them in layout
+    // order.
+    SmallPtrSet<BasicBlock *, 16> Reachable(Blocks.begin(), Blocks.end());
+    for (BasicBlock &BB : Func) {
+      if (!Reachable.count(&BB))
+        Blocks.emplace_back(&BB);
+    }
+  }
+
+  for (BasicBlock *BasicBlock : Blocks) {
+    for (Instruction &Inst : *BasicBlock) {
       // Don't lower GEPs directly, we'll handle them as we lower the root
       // pointer, typically a global variable or alloca.
       if (isa<GetElementPtrInst>(&Inst))
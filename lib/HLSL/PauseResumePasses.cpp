@@ -70,6 +70,10 @@ public:
 
   StringRef getPassName() const override { return "NoPausePasses"; }
 
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.setPreservesCFG();
+  }
+
   bool runOnModule(Module &M) override { return ClearPauseResumePasses(M); }
 };
 
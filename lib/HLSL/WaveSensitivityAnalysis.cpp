@@ -23,6 +23,7 @@
 
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Analysis/PostDominators.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DiagnosticInfo.h"
@@ -40,7 +41,6 @@
 #include <unordered_set>
 
 using namespace llvm;
-using std::map;
 
 namespace hlsl {
 
@@ -55,9 +55,9 @@ namespace hlsl {
 class WaveSensitivityAnalyzer : public WaveSensitivityAnalysis {
 private:
   enum WaveSensitivity { KnownSensitive, KnownNotSensitive, Unknown };
-  PostDominatorTree *pPDT;
-  map<Instruction *, WaveSensitivity> InstState;
-  map<BasicBlock *, WaveSensitivity> BBState;
+  DominatorTreeBase<BasicBlock> *pPDT;
+  DenseMap<Instruction *, WaveSensitivity> InstState;
+  DenseMap<BasicBlock *, WaveSensitivity> BBState;
   std::vector<Instruction *> InstWorkList;
   std::vector<PHINode *>
       UnknownPhis; // currently unknown phis. Indicate cycles after Analyze
@@ -69,14 +69,14 @@ private:
   void VisitInst(Instruction *I);
 
 public:
-  WaveSensitivityAnalyzer(PostDominatorTree &PDT) : pPDT(&PDT) {}
+  WaveSensitivityAnalyzer(DominatorTreeBase<BasicBlock> &PDT) : pPDT(&PDT) {}
   void Analyze(Function *F);
   void Analyze();
   bool IsWaveSensitive(Instruction *op);
 };
 
 WaveSensitivityAnalysis *
-WaveSensitivityAnalysis::create(PostDominatorTree &PDT) {
+WaveSensitivityAnalysis::create(DominatorTreeBase<BasicBlock> &PDT) {
   return new WaveSensitivityAnalyzer(PDT);
 }
 
@@ -1621,6 +1621,18 @@ bool isSafeAllocaToScalarRepl(AllocaInst *AI) {
 
 namespace {
 
+// Per-type ordering key for the SROAGlobalAndAllocas worklist.
+struct SROATypeSortKey {
+  uint64_t Size;
+  unsigned NestedLevel;
+  bool IsUnitSzStruct;
+};
+
+struct SROAWorkItem {
+  Value *V;
+  SROATypeSortKey Key;
+};
+
 struct GVDbgOffset {
   GlobalVariable *base;
   unsigned debugOffset;
@@ -1716,29 +1728,39 @@ bool SROAGlobalAndAllocas(HLModule &HLM, bool bHasDbgInfo) {
   // alloca. Big alloca will be split to smaller piece first, when process the
   // alloca, it will be alloca flattened from big alloca instead of a GEP of
   // big alloca.
-  auto size_cmp = [&DL](const Value *a0, const Value *a1) -> bool {
-    Type *a0ty = a0->getType()->getPointerElementType();
-    Type *a1ty = a1->getType()->getPointerElementType();
-    bool isUnitSzStruct0 =
-        a0ty->isStructTy() && a0ty->getStructNumElements() == 1;
-    bool isUnitSzStruct1 =
-        a1ty->isStructTy() && a1ty->getStructNumElements() == 1;
-    auto sz0 = DL.getTypeAllocSize(a0ty);
-    auto sz1 = DL.getTypeAllocSize(a1ty);
-    if (sz0 == sz1 && (isUnitSzStruct0 || isUnitSzStruct1)) {
-      sz0 = getNestedLevelInStruct(a0ty);
-      sz1 = getNestedLevelInStruct(a1ty);
+  // The sort key is computed once per type, since flattening arrays of
+  // structs pushes many elements of the same type.
+  DenseMap<Type *, SROATypeSortKey> SortKeyCache;
+  auto makeWorkItem = [&DL, &SortKeyCache](Value *V) -> SROAWorkItem {
+    Type *Ty = V->getType()->getPointerElementType();
+    auto It = SortKeyCache.find(Ty);
+    if (It == SortKeyCache.end()) {
+      SROATypeSortKey Key;
+      Key.Size = DL.getTypeAllocSize(Ty);
+      Key.NestedLevel = getNestedLevelInStruct(Ty);
+      Key.IsUnitSzStruct = Ty->isStructTy() && Ty->getStructNumElements() == 1;
+      It = SortKeyCache.insert(std::make_pair(Ty, Key)).first;
+    }
+    return {V, It->second};
+  };
+  auto size_cmp = [](const SROAWorkItem &a0, const SROAWorkItem &a1) -> bool {
+    uint64_t sz0 = a0.Key.Size;
+    uint64_t sz1 = a1.Key.Size;
+    if (sz0 == sz1 && (a0.Key.IsUnitSzStruct || a1.Key.IsUnitSzStruct)) {
+      sz0 = a0.Key.NestedLevel;
+      sz1 = a1.Key.NestedLevel;
     }
     // If sizes are equal, and the new value is a GV,
     // replace the existing node if it isn't GV or comes later alphabetically
     // Thus, entries are sorted by size, global variableness, and then name
     return sz0 < sz1 ||
-           (sz0 == sz1 && isa<GlobalVariable>(a1) &&
-            (!isa<GlobalVariable>(a0) || a0->getName() > a1->getName()));
+           (sz0 == sz1 && isa<GlobalVariable>(a1.V) &&
+            (!isa<GlobalVariable>(a0.V) || a0.V->getName() > a1.V->getName()));
   };
 
-  std::priority_queue<Value *, std::vector<Value *>,
-                      std::function<bool(Value *, Value *)>>
+  std::priority_queue<SROAWorkItem, std::vector<SROAWorkItem>,
+                      std::function<bool(const SROAWorkItem &,
+                                         const SROAWorkItem &)>>
       WorkList(size_cmp);
 
   // Flatten internal global.
@@ -1760,7 +1782,7 @@ bool SROAGlobalAndAllocas(HLModule &HLM, bool bHasDbgInfo) {
   }
   // Add static GVs to work list.
   for (GlobalVariable *GV : staticGVs)
-    WorkList.push(GV);
+    WorkList.push(makeWorkItem(GV));
 
   DenseMap<Function *, DominatorTree> domTreeMap;
   for (Function &F : M) {
@@ -1774,7 +1796,7 @@ bool SROAGlobalAndAllocas(HLModule &HLM, bool bHasDbgInfo) {
     for (BasicBlock::iterator I = BB.begin(), E = BB.end(); I != E; ++I)
       if (AllocaInst *A = dyn_cast<AllocaInst>(I)) {
         if (!A->user_empty()) {
-          WorkList.push(A);
+          WorkList.push(makeWorkItem(A));
           // merge GEP use for the allocs
           dxilutil::MergeGepUse(A);
         }
@@ -1797,7 +1819,7 @@ bool SROAGlobalAndAllocas(HLModule &HLM, bool bHasDbgInfo) {
 
   bool Changed = false;
   while (!WorkList.empty()) {
-    Value *V = WorkList.top();
+    Value *V = WorkList.top().V;
     WorkList.pop();
 
     if (AllocaInst *AI = dyn_cast<AllocaInst>(V)) {
@@ -1898,7 +1920,7 @@ bool SROAGlobalAndAllocas(HLModule &HLM, bool bHasDbgInfo) {
           // Push Elts into workList.
           for (unsigned EltIdx = 0; EltIdx < Elts.size(); ++EltIdx) {
             AllocaInst *EltAlloca = cast<AllocaInst>(Elts[EltIdx]);
-            WorkList.push(EltAlloca);
+            WorkList.push(makeWorkItem(EltAlloca));
           }
 
           // Now erase any instructions that were made dead while rewriting the
@@ -1985,7 +2007,7 @@ bool SROAGlobalAndAllocas(HLModule &HLM, bool bHasDbgInfo) {
         unsigned offset = 0;
         // Push Elts into workList.
         for (auto iter = Elts.begin(); iter != Elts.end(); iter++) {
-          WorkList.push(*iter);
+          WorkList.push(makeWorkItem(*iter));
           GlobalVariable *EltGV = cast<GlobalVariable>(*iter);
           if (bHasDbgInfo) {
             StringRef OriginEltName = EltGV->getName();
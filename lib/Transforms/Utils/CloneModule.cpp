@@ -33,6 +33,12 @@ Module *llvm::CloneModule(const Module *M) {
 }
 
 Module *llvm::CloneModule(const Module *M, ValueToValueMapTy &VMap) {
+  return CloneModule(M, VMap, /*CloneDefinitions*/ true); // HLSL Change
+}
+
+// HLSL Change - Add CloneDefinitions.
+Module *llvm::CloneModule(const Module *M, ValueToValueMapTy &VMap,
+                          bool CloneDefinitions) {
   // First off, we need to create the new module.
   Module *New = new Module(M->getModuleIdentifier(), M->getContext());
   New->setDataLayout(M->getDataLayout());
@@ -89,6 +95,13 @@ Module *llvm::CloneModule(const Module *M, ValueToValueMapTy &VMap) {
   //
   for (Module::const_iterator I = M->begin(), E = M->end(); I != E; ++I) {
     Function *F = cast<Function>(VMap[I]);
+    // HLSL Change Begin - Skip the bodies, leaving what deleteBody would.
+    if (!CloneDefinitions) {
+      if (!I->isDeclaration())
+        F->deleteBody();
+      continue;
+    }
+    // HLSL Change End
     if (!I->isDeclaration()) {
       Function::arg_iterator DestI = F->arg_begin();
       for (Function::const_arg_iterator J = I->arg_begin(); J != I->arg_end();
@@ -0,0 +1,63 @@
+//===-- OptimizerCache.h - SPIR-V Optimizer Cache ---------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares a cache of configured SPIRV-Tools optimizers, which lets
+// compilations on the same compiler object reuse the pass lists that earlier
+// compilations registered.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_SPIRV_OPTIMIZERCACHE_H
+#define LLVM_CLANG_SPIRV_OPTIMIZERCACHE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spvtools {
+class Optimizer;
+} // namespace spvtools
+
+namespace clang {
+namespace spirv {
+
+/// \brief Keeps SPIRV-Tools optimizers with their passes registered between
+/// compilations. Each optimizer is filed under a recipe string that identifies
+/// everything its passes depend on. The cache may be shared by compilations
+/// on several threads; an optimizer is only used by the compilation that took
+/// it out of the cache.
+class OptimizerCache {
+public:
+  OptimizerCache();
+  ~OptimizerCache();
+
+  /// Takes an optimizer for |recipe| out of the cache. Returns nullptr if
+  /// there is none.
+  std::unique_ptr<spvtools::Optimizer> take(const std::string &recipe);
+
+  /// Puts |optimizer| into the cache under |recipe|. The optimizer is dropped
+  /// if the cache is full.
+  void put(const std::string &recipe,
+           std::unique_ptr<spvtools::Optimizer> optimizer);
+
+private:
+  OptimizerCache(const OptimizerCache &) = delete;
+  OptimizerCache &operator=(const OptimizerCache &) = delete;
+
+  std::mutex mutex;
+  std::vector<std::pair<std::string, std::unique_ptr<spvtools::Optimizer>>>
+      optimizers;
+};
+
+} // end namespace spirv
+} // end namespace clang
+
+#endif // LLVM_CLANG_SPIRV_OPTIMIZERCACHE_H
@@ -0,0 +1,70 @@
+//===-- ReflectionBlob.h - SPIR-V Reflection Blob ---------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the writer for the compact reflection blob that can be
+// returned alongside a SPIR-V module, so that runtimes can create pipelines
+// without parsing the SPIR-V module themselves.
+//
+// The blob is a sequence of 32-bit words:
+//
+//   Header:      magic ('SPRF'), version, entry point count, resource count
+//   Entry point: execution model, LocalSize x, y and z (0 if not declared),
+//                name, interface variable count, and for each interface
+//                variable: storage class, Location and BuiltIn (~0u if absent)
+//   Resource:    storage class, DescriptorSet and Binding (~0u if absent),
+//                opcode of the descriptor type with arrays stripped,
+//                ReflectionDescriptorKind, image Dim (~0u if not an image),
+//                array element count (0 for runtime arrays, 1 if not an
+//                array), block size in bytes (0 if not a block), block member
+//                count, the Offset of each block member, name
+//   Name:        word count, followed by the words of a SPIR-V literal string
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_SPIRV_REFLECTIONBLOB_H
+#define LLVM_CLANG_SPIRV_REFLECTIONBLOB_H
+
+#include "llvm/ADT/ArrayRef.h"
+
+#include <vector>
+
+namespace clang {
+namespace spirv {
+
+/// Magic number of the reflection blob: 'SPRF' in little-endian order.
+const uint32_t kReflectionBlobMagic = 0x46525053u;
+/// Version of the reflection blob layout described above.
+const uint32_t kReflectionBlobVersion = 2u;
+
+/// The kind of descriptor a resource is bound as. The values are those of
+/// VkDescriptorType, so runtimes can use them directly.
+enum class ReflectionDescriptorKind : uint32_t {
+  Sampler = 0,
+  CombinedImageSampler = 1,
+  SampledImage = 2,
+  StorageImage = 3,
+  UniformTexelBuffer = 4,
+  StorageTexelBuffer = 5,
+  UniformBuffer = 6,
+  StorageBuffer = 7,
+  InputAttachment = 10,
+  AccelerationStructure = 1000150000,
+  /// Push constants and shader record buffers are not bound as descriptors.
+  None = ~0u,
+};
+
+/// \brief Writes the reflection blob for the given SPIR-V module into |blob|.
+/// Returns false if the module could not be parsed.
+bool writeReflectionBlob(llvm::ArrayRef<uint32_t> module,
+                         std::vector<uint32_t> *blob);
+
+} // end namespace spirv
+} // end namespace clang
+
+#endif // LLVM_CLANG_SPIRV_REFLECTIONBLOB_H
@@ -411,6 +411,29 @@ public:
     return declToDebugFunction[decl];
   }
 
+  /// A struct type lowered by LowerTypeVisitor, and whether lowering it
+  /// needed SPIR-V arrays for HLSL 1xN matrices.
+  struct LoweredStructType {
+    const SpirvType *type;
+    bool useArrayForMat1xN;
+  };
+
+  /// Function to add/get the SPIR-V type a struct decl was lowered to with
+  /// the given layout rule. This lets all LowerTypeVisitor instances share the
+  /// work of lowering a struct and computing its layout.
+  void registerLoweredStructType(const RecordDecl *decl, SpirvLayoutRule rule,
+                                 const SpirvType *spvTy,
+                                 bool useArrayForMat1xN) {
+    assert(decl != nullptr && spvTy != nullptr);
+    loweredStructTypes[{decl, static_cast<unsigned>(rule)}] = {
+        spvTy, useArrayForMat1xN};
+  }
+  const LoweredStructType *getLoweredStructType(const RecordDecl *decl,
+                                                SpirvLayoutRule rule) const {
+    auto it = loweredStructTypes.find({decl, static_cast<unsigned>(rule)});
+    return it == loweredStructTypes.end() ? nullptr : &it->second;
+  }
+
   /// Adds inst to instructionsWithLoweredType.
   void addToInstructionsWithLoweredType(const SpirvInstruction *inst) {
     instructionsWithLoweredType.insert(inst);
@@ -520,6 +543,10 @@ private:
 
   // Set of instructions that already have lowered SPIR-V types.
   llvm::DenseSet<const SpirvInstruction *> instructionsWithLoweredType;
+
+  // Mapping from a struct decl and layout rule to its lowered SPIR-V type.
+  llvm::DenseMap<std::pair<const RecordDecl *, unsigned>, LoweredStructType>
+      loweredStructTypes;
 };
 
 } // end namespace spirv
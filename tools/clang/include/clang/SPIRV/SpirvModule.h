@@ -160,6 +160,9 @@ public:
 
   llvm::ArrayRef<SpirvVariable *> getVariables() const { return variables; }
 
+  // Returns the functions of the module in the order they are emitted.
+  llvm::ArrayRef<SpirvFunction *> getFunctions() const { return functions; }
+
   llvm::ArrayRef<SpirvEntryPoint *> getEntryPoints() const {
     return entryPoints;
   }
@@ -29,6 +29,19 @@ public:
     Done, //< After finishing the visit of the given construct
   };
 
+  /// Kinds of module state that visitors read or write. Visitors declare the
+  /// state they touch so that FusedVisitor can check that the visitors sharing
+  /// a traversal don't depend on each other. AST types and the code generation
+  /// options never change during the visits and are not listed.
+  enum ModuleState : uint32_t {
+    MS_None = 0,
+    MS_Types = 1 << 0,            //< SPIR-V types of instructions and functions
+    MS_NonUniform = 1 << 1,       //< NonUniform flags of instructions
+    MS_RelaxedPrecision = 1 << 2, //< RelaxedPrecision flags of instructions
+    MS_Capabilities = 1 << 3,     //< Capabilities, extensions, memory model
+    MS_All = ~0u,
+  };
+
   // Virtual destructor
   virtual ~Visitor() = default;
 
@@ -151,6 +164,11 @@ public:
 
   const SpirvCodeGenOptions &getCodeGenOptions() const { return spvOptions; }
 
+  /// The ModuleState this visitor reads and writes. Visitors that don't
+  /// declare them are assumed to touch everything, and can't be fused.
+  virtual uint32_t getReadState() const { return MS_All; }
+  virtual uint32_t getWrittenState() const { return MS_All; }
+
 protected:
   explicit Visitor(const SpirvCodeGenOptions &opts, SpirvContext &ctx)
       : spvOptions(opts), context(ctx) {}
@@ -43,6 +43,11 @@ public:
 
   using Visitor::visit;
 
+  uint32_t getReadState() const override {
+    return MS_Types | MS_NonUniform | MS_Capabilities;
+  }
+  uint32_t getWrittenState() const override { return MS_Capabilities; }
+
   /// The "sink" visit function for all instructions.
   ///
   /// By default, all other visit instructions redirect to this visit function.
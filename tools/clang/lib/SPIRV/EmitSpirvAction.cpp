@@ -16,8 +16,55 @@
 
 namespace clang {
 
+namespace {
+/// Translates the parsed translation unit once for each entry point given
+/// with -fspv-entry-points, as if it was compiled with -E for each of them.
+/// The entry points share the AST, and each of them is translated by its own
+/// SpirvEmitter, one after the other.
+class MultiEntrySpirvConsumer : public ASTConsumer {
+public:
+  explicit MultiEntrySpirvConsumer(CompilerInstance &ci) : ci(ci) {}
+
+  void HandleTranslationUnit(ASTContext &context) override {
+    CodeGenOptions &codeGenOpts = ci.getCodeGenOpts();
+    const std::string mainEntry = codeGenOpts.HLSLEntryFunction;
+    for (llvm::StringRef entry : codeGenOpts.SpirvOptions.entryPoints) {
+      if (!hasFunction(context, entry)) {
+        DiagnosticsEngine &diags = context.getDiagnostics();
+        diags.Report(diags.getCustomDiagID(
+            DiagnosticsEngine::Error,
+            "entry point '%0' given with -fspv-entry-points is not defined"))
+            << entry;
+        break;
+      }
+
+      codeGenOpts.HLSLEntryFunction = entry;
+      spirv::SpirvEmitter emitter(ci);
+      emitter.HandleTranslationUnit(context);
+      if (context.getDiagnostics().hasErrorOccurred())
+        break;
+    }
+    codeGenOpts.HLSLEntryFunction = mainEntry;
+  }
+
+private:
+  static bool hasFunction(ASTContext &context, llvm::StringRef name) {
+    for (auto *decl : context.getTranslationUnitDecl()->decls()) {
+      if (auto *funcDecl = dyn_cast<FunctionDecl>(decl))
+        if (funcDecl->getIdentifier() && funcDecl->getName() == name)
+          return true;
+    }
+    return false;
+  }
+
+  CompilerInstance &ci;
+};
+} // namespace
+
 std::unique_ptr<ASTConsumer>
 EmitSpirvAction::CreateASTConsumer(CompilerInstance &CI, StringRef InFile) {
+  if (!CI.getCodeGenOpts().SpirvOptions.entryPoints.empty())
+    return llvm::make_unique<MultiEntrySpirvConsumer>(CI);
   return llvm::make_unique<spirv::SpirvEmitter>(CI);
 }
 } // end namespace clang
@@ -19,6 +19,7 @@
 #include "clang/SPIRV/SpirvBasicBlock.h"
 #include "clang/SPIRV/SpirvFunction.h"
 #include "clang/SPIRV/SpirvInstruction.h"
+#include "clang/SPIRV/SpirvModule.h"
 #include "clang/SPIRV/SpirvType.h"
 #include "clang/SPIRV/String.h"
 // clang-format on
@@ -207,7 +208,15 @@ EmitVisitor::getOrAssignResultId<SpirvInstruction>(SpirvInstruction *obj) {
   }
 
   if (!obj->getResultId()) {
-    obj->setResultId(takeNextId());
+    // Strings and debug sources may be created while emitting a function, but
+    // are part of the module.
+    if (str != nullptr || isa<SpirvDebugSource>(obj)) {
+      obj->setResultId(takeNextId());
+    } else {
+      obj->setResultId(takeNextLocalId());
+      if (numberingFunctions && obj->getResultId() >= kFirstProvisionalId)
+        provisionalInstructions.push_back(obj);
+    }
   }
   if (str != nullptr) {
     stringIdMap[str->getString()] = obj->getResultId();
@@ -215,14 +224,19 @@ EmitVisitor::getOrAssignResultId<SpirvInstruction>(SpirvInstruction *obj) {
   return obj->getResultId();
 }
 
+template <>
+uint32_t
+EmitVisitor::getOrAssignResultId<SpirvBasicBlock>(SpirvBasicBlock *obj) {
+  if (!obj->getResultId()) {
+    obj->setResultId(takeNextLocalId());
+    if (numberingFunctions && obj->getResultId() >= kFirstProvisionalId)
+      provisionalBlocks.push_back(obj);
+  }
+  return obj->getResultId();
+}
+
 std::vector<uint32_t> EmitVisitor::Header::takeBinary() {
-  std::vector<uint32_t> words;
-  words.push_back(magicNumber);
-  words.push_back(version);
-  words.push_back(generator);
-  words.push_back(bound);
-  words.push_back(reserved);
-  return words;
+  return {magicNumber, version, generator, bound, reserved};
 }
 
 uint32_t EmitVisitor::getOrCreateOpStringId(llvm::StringRef str) {
@@ -248,9 +262,13 @@ uint32_t EmitVisitor::getLiteralEncodedForDebugInfo(uint32_t val) {
 void EmitVisitor::emitDebugNameForInstruction(uint32_t resultId,
                                               llvm::StringRef debugName) {
   // Most instructions do not have a debug name associated with them.
-  if (debugName.empty())
+  if (debugName.empty() || !canEmitModuleInstructions())
     return;
 
+  if (resultId >= kFirstProvisionalId)
+    provisionalIdWords.emplace_back(&debugVariableBinary,
+                                    debugVariableBinary.size() + 1);
+
   curInst.clear();
   curInst.push_back(static_cast<uint32_t>(spv::Op::OpName));
   curInst.push_back(resultId);
@@ -260,6 +278,18 @@ void EmitVisitor::emitDebugNameForInstruction(uint32_t resultId,
                              curInst.end());
 }
 
+void EmitVisitor::emitDecoration(uint32_t targetId, spv::Decoration decoration,
+                                 llvm::ArrayRef<uint32_t> decorationParams) {
+  if (!canEmitModuleInstructions())
+    return;
+
+  if (targetId >= kFirstProvisionalId)
+    provisionalIdWords.emplace_back(&annotationsBinary,
+                                    annotationsBinary.size() + 1);
+
+  typeHandler.emitDecoration(targetId, decoration, decorationParams);
+}
+
 void EmitVisitor::emitDebugLine(spv::Op op, const SourceLocation &loc,
                                 const SourceRange &range,
                                 std::vector<uint32_t> *section,
@@ -313,7 +343,7 @@ void EmitVisitor::emitDebugLine(spv::Op op, const SourceLocation &loc,
       if (spvOptions.debugInfoVulkan) {
         curInst.push_back(static_cast<uint32_t>(spv::Op::OpExtInst));
         curInst.push_back(typeHandler.emitType(context.getVoidType()));
-        curInst.push_back(takeNextId());
+        curInst.push_back(takeNextLocalId());
         curInst.push_back(debugInfoExtInstId);
         curInst.push_back(104u); // DebugNoLine
       } else {
@@ -400,7 +430,7 @@ void EmitVisitor::emitDebugLine(spv::Op op, const SourceLocation &loc,
   } else {
     curInst.push_back(static_cast<uint32_t>(spv::Op::OpExtInst));
     curInst.push_back(typeHandler.emitType(context.getVoidType()));
-    curInst.push_back(takeNextId());
+    curInst.push_back(takeNextLocalId());
     curInst.push_back(debugInfoExtInstId);
     curInst.push_back(103u); // DebugLine
     curInst.push_back(emittedSource[fileId]);
@@ -422,18 +452,18 @@ void EmitVisitor::initInstruction(SpirvInstruction *inst) {
 
   // Emit NonUniformEXT decoration (if any).
   if (inst->isNonUniform()) {
-    typeHandler.emitDecoration(getOrAssignResultId<SpirvInstruction>(inst),
-                               spv::Decoration::NonUniformEXT, {});
+    emitDecoration(getOrAssignResultId<SpirvInstruction>(inst),
+                   spv::Decoration::NonUniformEXT, {});
   }
   // Emit RelaxedPrecision decoration (if any).
   if (inst->isRelaxedPrecision()) {
-    typeHandler.emitDecoration(getOrAssignResultId<SpirvInstruction>(inst),
-                               spv::Decoration::RelaxedPrecision, {});
+    emitDecoration(getOrAssignResultId<SpirvInstruction>(inst),
+                   spv::Decoration::RelaxedPrecision, {});
   }
   // Emit NoContraction decoration (if any).
   if (inst->isPrecise() && inst->isArithmeticInstruction()) {
-    typeHandler.emitDecoration(getOrAssignResultId<SpirvInstruction>(inst),
-                               spv::Decoration::NoContraction, {});
+    emitDecoration(getOrAssignResultId<SpirvInstruction>(inst),
+                   spv::Decoration::NoContraction, {});
   }
 
   // According to Section 2.4. Logical Layout of a Module in the SPIR-V spec:
@@ -468,9 +498,18 @@ void EmitVisitor::finalizeInstruction(std::vector<uint32_t> *section) {
 }
 
 std::vector<uint32_t> EmitVisitor::takeBinary() {
-  std::vector<uint32_t> result;
   Header header(takeNextId(), getHeaderVersion(featureManager.getTargetEnv()));
   auto headerBinary = header.takeBinary();
+
+  // The sections are filled in interleaved order while emitting, so they are
+  // only concatenated here. Size the result up front so that the whole module
+  // is copied exactly once.
+  std::vector<uint32_t> result;
+  result.reserve(headerBinary.size() + preambleBinary.size() +
+                 debugFileBinary.size() + debugVariableBinary.size() +
+                 annotationsBinary.size() + typeConstantBinary.size() +
+                 globalVarsBinary.size() + richDebugInfo.size() +
+                 mainBinary.size());
   result.insert(result.end(), headerBinary.begin(), headerBinary.end());
   result.insert(result.end(), preambleBinary.begin(), preambleBinary.end());
   result.insert(result.end(), debugFileBinary.begin(), debugFileBinary.end());
@@ -491,8 +530,53 @@ void EmitVisitor::encodeString(llvm::StringRef value) {
   curInst.insert(curInst.end(), words.begin(), words.end());
 }
 
-bool EmitVisitor::visit(SpirvModule *, Phase) {
-  // No pre-visit operations needed for SpirvModule.
+bool EmitVisitor::visit(SpirvModule *module, Phase phase) {
+  // Keep the module to number its functions before emitting the first one.
+  if (phase == Visitor::Phase::Init)
+    spvModule = module;
+  return true;
+}
+
+bool EmitVisitor::numberFunctions() {
+  assert(spvModule && !functionsNumbered);
+  functionsNumbered = true;
+  numberingFunctions = true;
+
+  // Only the module sections are kept from this visit.
+  std::vector<uint32_t> functionBodies;
+  functionBodies.swap(mainBinary);
+  localId = kFirstProvisionalId - 1;
+  for (auto *fn : spvModule->getFunctions())
+    if (!fn->invokeVisitor(this))
+      return false;
+  mainBinary.swap(functionBodies);
+  numberingFunctions = false;
+
+  // The function bodies follow the module in the result-id space. Replace the
+  // provisional result-ids accordingly, and let the final visit of the
+  // function bodies assign them again.
+  const uint32_t firstLocalId = id + 1;
+  const uint32_t numLocalIds = localId - (kFirstProvisionalId - 1);
+  assert(firstLocalId < kFirstProvisionalId &&
+         numLocalIds < kFirstProvisionalId - firstLocalId);
+  for (auto &word : provisionalIdWords)
+    (*word.first)[word.second] =
+        (*word.first)[word.second] - kFirstProvisionalId + firstLocalId;
+  for (auto &info : functionEmitInfo) {
+    info.second.firstLocalId =
+        info.second.firstLocalId - kFirstProvisionalId + firstLocalId;
+    info.second.lastLocalId =
+        info.second.lastLocalId - kFirstProvisionalId + firstLocalId;
+  }
+  for (auto *inst : provisionalInstructions)
+    inst->setResultId(0);
+  for (auto *bb : provisionalBlocks)
+    bb->setResultId(0);
+  provisionalIdWords.clear();
+  provisionalInstructions.clear();
+  provisionalBlocks.clear();
+
+  id += numLocalIds;
   return true;
 }
 
@@ -501,6 +585,28 @@ bool EmitVisitor::visit(SpirvFunction *fn, Phase phase) {
 
   // Before emitting the function
   if (phase == Visitor::Phase::Init) {
+    if (!functionsNumbered && !numberFunctions())
+      return false;
+
+    curFunction = fn;
+    if (numberingFunctions) {
+      FunctionEmitInfo &info = functionEmitInfo[fn];
+      info.firstLocalId = localId + 1;
+      info.debugLineStart = debugLineStart;
+      info.debugLineEnd = debugLineEnd;
+      info.debugColumnStart = debugColumnStart;
+      info.debugColumnEnd = debugColumnEnd;
+      info.lastOpWasMergeInst = lastOpWasMergeInst;
+    } else {
+      const FunctionEmitInfo &info = functionEmitInfo[fn];
+      localId = info.firstLocalId - 1;
+      debugLineStart = info.debugLineStart;
+      debugLineEnd = info.debugLineEnd;
+      debugColumnStart = info.debugColumnStart;
+      debugColumnEnd = info.debugColumnEnd;
+      lastOpWasMergeInst = info.lastOpWasMergeInst;
+    }
+
     const uint32_t returnTypeId = typeHandler.emitType(fn->getReturnType());
     const uint32_t functionTypeId = typeHandler.emitType(fn->getFunctionType());
 
@@ -522,8 +628,8 @@ bool EmitVisitor::visit(SpirvFunction *fn, Phase phase) {
 
     // RelaxedPrecision decoration may be applied to an OpFunction instruction.
     if (fn->isRelaxedPrecision())
-      typeHandler.emitDecoration(getOrAssignResultId<SpirvFunction>(fn),
-                                 spv::Decoration::RelaxedPrecision, {});
+      emitDecoration(getOrAssignResultId<SpirvFunction>(fn),
+                     spv::Decoration::RelaxedPrecision, {});
   }
   // After emitting the function
   else if (phase == Visitor::Phase::Done) {
@@ -531,6 +637,13 @@ bool EmitVisitor::visit(SpirvFunction *fn, Phase phase) {
     initInstruction(spv::Op::OpFunctionEnd, /* SourceLocation */ {});
     finalizeInstruction(&mainBinary);
     inEntryFunctionWrapper = false;
+
+    if (numberingFunctions)
+      functionEmitInfo[fn].lastLocalId = localId;
+    else
+      assert(localId == functionEmitInfo[fn].lastLocalId &&
+             "function body used other result-ids than when numbered");
+    curFunction = nullptr;
   }
 
   return true;
@@ -765,9 +878,9 @@ bool EmitVisitor::visit(SpirvVariable *inst) {
       }
     }
 
-    typeHandler.emitDecoration(getOrAssignResultId<SpirvInstruction>(inst),
-                               spv::Decoration::UserTypeGOOGLE,
-                               string::encodeSPIRVString(formattedUserType));
+    emitDecoration(getOrAssignResultId<SpirvInstruction>(inst),
+                   spv::Decoration::UserTypeGOOGLE,
+                   string::encodeSPIRVString(formattedUserType));
   }
   return true;
 }
@@ -203,7 +203,8 @@ public:
   EmitVisitor(ASTContext &astCtx, SpirvContext &spvCtx,
               const SpirvCodeGenOptions &opts, FeatureManager &featureMgr)
       : Visitor(opts, spvCtx), astContext(astCtx), featureManager(featureMgr),
-        id(0),
+        id(0), localId(0), spvModule(nullptr), curFunction(nullptr),
+        functionsNumbered(false), numberingFunctions(false),
         typeHandler(astCtx, spvCtx, opts, featureMgr, &debugVariableBinary,
                     &annotationsBinary, &typeConstantBinary,
                     [this]() -> uint32_t { return takeNextId(); }),
@@ -312,9 +313,32 @@ public:
   std::vector<uint32_t> takeBinary();
 
 private:
+  // Per function state that is recorded while numbering the function bodies,
+  // so that each function can later be emitted on its own.
+  struct FunctionEmitInfo {
+    // The range of result-ids defined in the function body.
+    uint32_t firstLocalId;
+    uint32_t lastLocalId;
+    // The debug line state at the start of the function.
+    uint32_t debugLineStart;
+    uint32_t debugLineEnd;
+    uint32_t debugColumnStart;
+    uint32_t debugColumnEnd;
+    bool lastOpWasMergeInst;
+  };
+
+  // Result-ids of function bodies are provisional while the function bodies
+  // are numbered, and are taken from this range so that they can be told apart
+  // from the result-ids of the module.
+  static const uint32_t kFirstProvisionalId = 0x80000000u;
+
   // Returns the next available result-id.
   uint32_t takeNextId() { return ++id; }
 
+  // Returns the next available result-id for a result defined in the body of
+  // the function being emitted, or for the module if there is none.
+  uint32_t takeNextLocalId() { return curFunction ? ++localId : takeNextId(); }
+
   // There is no guarantee that an instruction or a function or a basic block
   // has been assigned result-id. This method returns the result-id for the
   // given object. If a result-id has not been assigned yet, it'll assign
@@ -326,6 +350,29 @@ private:
     return obj->getResultId();
   }
 
+  // Numbers the result-ids of the module before any function body is emitted.
+  //
+  // The function bodies are visited once with their output discarded. This
+  // emits the types, constants and other module level instructions they use,
+  // together with the names and decorations of their results, and counts the
+  // results of each function. The result-ids of the module are then final, and
+  // each function gets the range of result-ids following the ones of the
+  // functions before it. Emitting a function afterwards only reads the module
+  // level state and its own range, so the output does not depend on the order
+  // in which the functions are emitted.
+  bool numberFunctions();
+
+  // Returns true if instructions of the module sections, other than the
+  // function bodies, may be emitted. These are all emitted before the final
+  // visit of the function bodies.
+  bool canEmitModuleInstructions() const {
+    return !curFunction || numberingFunctions;
+  }
+
+  // Emits a decoration for the given instruction or function result-id.
+  void emitDecoration(uint32_t targetId, spv::Decoration,
+                      llvm::ArrayRef<uint32_t> decorationParams = {});
+
   /// If we already created OpString for str, just return the id of the created
   /// one. Otherwise, create it, keep it in stringIdMap, and return its id.
   uint32_t getOrCreateOpStringId(llvm::StringRef str);
@@ -414,6 +461,23 @@ private:
   FeatureManager featureManager;
   // The last result-id that's been used so far.
   uint32_t id;
+  // The last result-id that's been used so far in the current function body.
+  uint32_t localId;
+  // The module being emitted.
+  SpirvModule *spvModule;
+  // The function whose body is being emitted, if any.
+  SpirvFunction *curFunction;
+  // True once the function bodies are numbered, see numberFunctions().
+  bool functionsNumbered;
+  // True while the function bodies are numbered.
+  bool numberingFunctions;
+  // Per function state recorded while numbering the function bodies.
+  llvm::DenseMap<const SpirvFunction *, FunctionEmitInfo> functionEmitInfo;
+  // Instructions and basic blocks that were given a provisional result-id.
+  std::vector<SpirvInstruction *> provisionalInstructions;
+  std::vector<SpirvBasicBlock *> provisionalBlocks;
+  // Words of the module sections that hold a provisional result-id.
+  std::vector<std::pair<std::vector<uint32_t> *, size_t>> provisionalIdWords;
   // Handler for emitting types and their related instructions.
   EmitTypeHandler typeHandler;
   // Current instruction being built
@@ -0,0 +1,84 @@
+//===--- FusedVisitor.cpp - Fused Visitor ------------------------*- C++ -*-==//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "FusedVisitor.h"
+#include "clang/SPIRV/SpirvBasicBlock.h"
+#include "clang/SPIRV/SpirvFunction.h"
+#include "clang/SPIRV/SpirvModule.h"
+
+namespace clang {
+namespace spirv {
+
+FusedVisitor::FusedVisitor(SpirvContext &spvCtx,
+                           const SpirvCodeGenOptions &opts,
+                           std::initializer_list<Visitor *> visitors)
+    : Visitor(opts, spvCtx) {
+  for (auto *visitor : visitors) {
+    assert(visitor && "cannot fuse a null visitor");
+    // The traversal consults the visitor's options (e.g. the debug info
+    // flavor) to decide what to visit, so all fused visitors must agree.
+    assert(&visitor->getCodeGenOptions() == &opts &&
+           "fused visitors must share the same code generation options");
+    // Each visitor must see the module as if it traversed it alone, so it
+    // can't depend on state that another visitor changes along the way.
+    for (const auto &entry : entries) {
+      (void)entry;
+      assert(!((visitor->getReadState() | visitor->getWrittenState()) &
+               entry.visitor->getWrittenState()) &&
+             !((entry.visitor->getReadState() |
+                entry.visitor->getWrittenState()) &
+               visitor->getWrittenState()) &&
+             "fused visitors must not depend on each other");
+    }
+    entries.push_back({visitor, true});
+  }
+}
+
+uint32_t FusedVisitor::getReadState() const {
+  uint32_t state = MS_None;
+  for (const auto &entry : entries)
+    state |= entry.visitor->getReadState();
+  return state;
+}
+
+uint32_t FusedVisitor::getWrittenState() const {
+  uint32_t state = MS_None;
+  for (const auto &entry : entries)
+    state |= entry.visitor->getWrittenState();
+  return state;
+}
+
+template <typename Functor> bool FusedVisitor::forward(Functor fn) {
+  bool anyActive = false;
+  for (auto &entry : entries) {
+    if (entry.active)
+      entry.active = fn(entry.visitor);
+    anyActive |= entry.active;
+  }
+  return anyActive;
+}
+
+bool FusedVisitor::visit(SpirvModule *mod, Phase phase) {
+  return forward([mod, phase](Visitor *v) { return v->visit(mod, phase); });
+}
+
+bool FusedVisitor::visit(SpirvFunction *fn, Phase phase) {
+  return forward([fn, phase](Visitor *v) { return v->visit(fn, phase); });
+}
+
+bool FusedVisitor::visit(SpirvBasicBlock *bb, Phase phase) {
+  return forward([bb, phase](Visitor *v) { return v->visit(bb, phase); });
+}
+
+bool FusedVisitor::visitInstruction(SpirvInstruction *instr) {
+  return forward([instr](Visitor *v) { return instr->invokeVisitor(v); });
+}
+
+} // end namespace spirv
+} // end namespace clang
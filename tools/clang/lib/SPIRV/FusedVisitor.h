@@ -0,0 +1,71 @@
+//===--- FusedVisitor.h - Fused Visitor --------------------------*- C++ -*-==//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LIB_SPIRV_FUSEDVISITOR_H
+#define LLVM_CLANG_LIB_SPIRV_FUSEDVISITOR_H
+
+#include "clang/SPIRV/SpirvVisitor.h"
+#include "llvm/ADT/SmallVector.h"
+
+#include <initializer_list>
+
+namespace clang {
+namespace spirv {
+
+/// Runs several visitors over the module in a single traversal.
+///
+/// Every construct is forwarded to each of the given visitors in the order
+/// they were passed in, so each visitor observes exactly the same sequence of
+/// calls it would observe if it traversed the module on its own. Fusing is
+/// therefore only valid for visitors that run in the same direction and that
+/// do not read any state written by a visitor that follows them in the list.
+///
+/// A visitor that returns false stops receiving calls for the rest of the
+/// traversal, which mirrors the early exit of an unfused traversal without
+/// affecting the other visitors. The traversal itself stops once no visitor is
+/// active anymore.
+///
+/// Each visitor declares the module state it reads and writes. Visitors may
+/// only be fused if none of them reads or writes state that another one
+/// writes, which is asserted on construction.
+class FusedVisitor : public Visitor {
+public:
+  FusedVisitor(SpirvContext &spvCtx, const SpirvCodeGenOptions &opts,
+               std::initializer_list<Visitor *> visitors);
+
+  bool visit(SpirvModule *, Phase) override;
+  bool visit(SpirvFunction *, Phase) override;
+  bool visit(SpirvBasicBlock *, Phase) override;
+
+  using Visitor::visit;
+
+  uint32_t getReadState() const override;
+  uint32_t getWrittenState() const override;
+
+  /// All instructions end up here through the default visit methods; they are
+  /// dispatched again on their dynamic type to each active visitor.
+  bool visitInstruction(SpirvInstruction *) override;
+
+private:
+  /// Calls fn on every visitor that is still active and records which of them
+  /// asked to stop. Returns true if any visitor remains active.
+  template <typename Functor> bool forward(Functor fn);
+
+private:
+  struct Entry {
+    Visitor *visitor;
+    bool active;
+  };
+  llvm::SmallVector<Entry, 4> entries;
+};
+
+} // end namespace spirv
+} // end namespace clang
+
+#endif // LLVM_CLANG_LIB_SPIRV_FUSEDVISITOR_H
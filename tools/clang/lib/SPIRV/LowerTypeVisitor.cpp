@@ -519,11 +519,29 @@ const SpirvType *LowerTypeVisitor::lowerType(QualType type,
       return spvType;
     }
 
+    // Lowering a struct and computing its layout is done once per layout rule
+    // and shared through the SpirvContext.
+    if (const auto *lowered = spvContext.getLoweredStructType(decl, rule)) {
+      useArrayForMat1xN |= lowered->useArrayForMat1xN;
+      spvContext.registerStructDeclForSpirvType(lowered->type, decl);
+      return lowered->type;
+    }
+
+    // Track whether this struct itself needs arrays for 1xN matrices, so the
+    // cached result carries it to later users.
+    const bool outerUseArrayForMat1xN = useArrayForMat1xN;
+    useArrayForMat1xN = false;
+
     auto loweredFields = lowerStructFields(decl, rule);
 
     const auto *spvStructType =
         spvContext.getStructType(loweredFields, decl->getName());
     spvContext.registerStructDeclForSpirvType(spvStructType, decl);
+    if (!astContext.getDiagnostics().hasErrorOccurred())
+      spvContext.registerLoweredStructType(decl, rule, spvStructType,
+                                           useArrayForMat1xN);
+
+    useArrayForMat1xN |= outerUseArrayForMat1xN;
     return spvStructType;
   }
 
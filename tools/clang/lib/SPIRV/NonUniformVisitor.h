@@ -41,6 +41,9 @@ public:
 
   using Visitor::visit;
 
+  uint32_t getReadState() const override { return MS_NonUniform; }
+  uint32_t getWrittenState() const override { return MS_NonUniform; }
+
   /// The "sink" visit function for all instructions.
   ///
   /// By default, all other visit instructions redirect to this visit function.
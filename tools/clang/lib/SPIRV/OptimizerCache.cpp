@@ -0,0 +1,47 @@
+//===-- OptimizerCache.cpp - SPIR-V Optimizer Cache -------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/SPIRV/OptimizerCache.h"
+#include "spirv-tools/optimizer.hpp"
+
+namespace clang {
+namespace spirv {
+
+namespace {
+/// The number of optimizers kept at most. Each compilation runs at most one
+/// legalization and one optimization recipe, so this covers a few concurrent
+/// compilations with different options.
+const size_t kMaxOptimizers = 16;
+} // namespace
+
+OptimizerCache::OptimizerCache() = default;
+OptimizerCache::~OptimizerCache() = default;
+
+std::unique_ptr<spvtools::Optimizer>
+OptimizerCache::take(const std::string &recipe) {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto it = optimizers.begin(); it != optimizers.end(); ++it) {
+    if (it->first == recipe) {
+      std::unique_ptr<spvtools::Optimizer> optimizer = std::move(it->second);
+      optimizers.erase(it);
+      return optimizer;
+    }
+  }
+  return nullptr;
+}
+
+void OptimizerCache::put(const std::string &recipe,
+                         std::unique_ptr<spvtools::Optimizer> optimizer) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (optimizers.size() < kMaxOptimizers)
+    optimizers.emplace_back(recipe, std::move(optimizer));
+}
+
+} // end namespace spirv
+} // end namespace clang
@@ -0,0 +1,486 @@
+//===-- ReflectionBlob.cpp - SPIR-V Reflection Blob -------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/SPIRV/ReflectionBlob.h"
+#include "spirv/unified1/spirv.hpp11"
+#include "clang/SPIRV/String.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+namespace clang {
+namespace spirv {
+
+namespace {
+
+/// Value written for decorations and execution modes that are absent.
+const uint32_t kNone = ~0u;
+
+/// A type declaration, with the operands that follow its result id.
+struct TypeDecl {
+  spv::Op opcode;
+  llvm::SmallVector<uint32_t, 4> operands;
+};
+
+/// The layout decorations of a struct member.
+struct MemberLayout {
+  MemberLayout() : offset(0), matrixStride(0), rowMajor(false) {}
+
+  uint32_t offset;
+  uint32_t matrixStride;
+  bool rowMajor;
+};
+
+struct EntryPoint {
+  uint32_t executionModel;
+  uint32_t function;
+  std::string name;
+  std::vector<uint32_t> interfaces;
+};
+
+struct Variable {
+  uint32_t id;
+  uint32_t pointerType;
+  spv::StorageClass storageClass;
+};
+
+bool isTypeDeclaration(spv::Op opcode) {
+  switch (opcode) {
+  case spv::Op::OpTypeVoid:
+  case spv::Op::OpTypeBool:
+  case spv::Op::OpTypeInt:
+  case spv::Op::OpTypeFloat:
+  case spv::Op::OpTypeVector:
+  case spv::Op::OpTypeMatrix:
+  case spv::Op::OpTypeImage:
+  case spv::Op::OpTypeSampler:
+  case spv::Op::OpTypeSampledImage:
+  case spv::Op::OpTypeArray:
+  case spv::Op::OpTypeRuntimeArray:
+  case spv::Op::OpTypeStruct:
+  case spv::Op::OpTypePointer:
+  case spv::Op::OpTypeFunction:
+  case spv::Op::OpTypeAccelerationStructureKHR:
+  case spv::Op::OpTypeRayQueryKHR:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Returns the number of operands after the result id that the size and
+/// descriptor computations below rely on.
+size_t getMinTypeOperandCount(spv::Op opcode) {
+  switch (opcode) {
+  case spv::Op::OpTypeInt:
+  case spv::Op::OpTypeFloat:
+    return 1;
+  case spv::Op::OpTypeSampledImage:
+    return 1;
+  case spv::Op::OpTypeVector:
+  case spv::Op::OpTypeMatrix:
+  case spv::Op::OpTypeArray:
+  case spv::Op::OpTypePointer:
+    return 2;
+  case spv::Op::OpTypeImage:
+    return 7;
+  default:
+    return 0;
+  }
+}
+
+bool isResourceStorageClass(spv::StorageClass storageClass) {
+  switch (storageClass) {
+  case spv::StorageClass::UniformConstant:
+  case spv::StorageClass::Uniform:
+  case spv::StorageClass::StorageBuffer:
+  case spv::StorageClass::PushConstant:
+  case spv::StorageClass::ShaderRecordBufferKHR:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void writeString(llvm::StringRef str, std::vector<uint32_t> *blob) {
+  const auto words = string::encodeSPIRVString(str);
+  blob->push_back(static_cast<uint32_t>(words.size()));
+  blob->insert(blob->end(), words.begin(), words.end());
+}
+
+/// The parts of a SPIR-V module the reflection blob is built from. Only the
+/// instructions before the first function are read.
+class ModuleInfo {
+public:
+  bool parse(llvm::ArrayRef<uint32_t> module);
+  void write(std::vector<uint32_t> *blob) const;
+
+private:
+  const TypeDecl *getType(uint32_t id) const;
+  uint32_t getConstant(uint32_t id) const;
+  uint32_t getDecoration(uint32_t id, spv::Decoration decoration) const;
+  uint32_t getSizeInBytes(uint32_t typeId, const MemberLayout &layout) const;
+  uint32_t getStructSizeInBytes(uint32_t structId) const;
+  const TypeDecl *getImageType(const TypeDecl *type) const;
+  ReflectionDescriptorKind getDescriptorKind(spv::StorageClass storageClass,
+                                             uint32_t typeId) const;
+  void writeResource(const Variable &var, std::vector<uint32_t> *blob) const;
+
+private:
+  std::vector<EntryPoint> entryPoints;
+  std::vector<Variable> variables;
+  llvm::DenseMap<uint32_t, std::array<uint32_t, 3>> localSizes;
+  llvm::DenseMap<uint32_t, std::array<uint32_t, 3>> localSizeIds;
+  llvm::DenseMap<uint32_t, std::string> names;
+  llvm::DenseMap<uint32_t, TypeDecl> types;
+  llvm::DenseMap<uint32_t, uint32_t> constants;
+  llvm::DenseMap<std::pair<uint32_t, uint32_t>, uint32_t> decorations;
+  llvm::DenseMap<uint32_t, llvm::SmallVector<MemberLayout, 8>> memberLayouts;
+};
+
+bool ModuleInfo::parse(llvm::ArrayRef<uint32_t> module) {
+  const size_t kHeaderSize = 5;
+  if (module.size() < kHeaderSize || module[0] != spv::MagicNumber)
+    return false;
+
+  for (size_t i = kHeaderSize; i < module.size();) {
+    const auto opcode = static_cast<spv::Op>(module[i] & spv::OpCodeMask);
+    const uint32_t wordCount = module[i] >> spv::WordCountShift;
+    if (wordCount == 0 || i + wordCount > module.size())
+      return false;
+    const auto operands = module.slice(i + 1, wordCount - 1);
+    i += wordCount;
+
+    switch (opcode) {
+    case spv::Op::OpEntryPoint: {
+      if (operands.size() < 3)
+        return false;
+      EntryPoint entryPoint;
+      entryPoint.executionModel = operands[0];
+      entryPoint.function = operands[1];
+      entryPoint.name = string::decodeSPIRVString(operands.slice(2));
+      const size_t nameWords = entryPoint.name.size() / 4 + 1;
+      if (2 + nameWords > operands.size())
+        return false;
+      const auto interfaces = operands.slice(2 + nameWords);
+      entryPoint.interfaces.assign(interfaces.begin(), interfaces.end());
+      entryPoints.push_back(std::move(entryPoint));
+      break;
+    }
+    case spv::Op::OpExecutionMode:
+    case spv::Op::OpExecutionModeId: {
+      if (operands.size() < 5)
+        break;
+      const auto mode = static_cast<spv::ExecutionMode>(operands[1]);
+      if (mode == spv::ExecutionMode::LocalSize)
+        localSizes[operands[0]] = {{operands[2], operands[3], operands[4]}};
+      else if (mode == spv::ExecutionMode::LocalSizeId)
+        localSizeIds[operands[0]] = {{operands[2], operands[3], operands[4]}};
+      break;
+    }
+    case spv::Op::OpName:
+      if (operands.size() >= 2)
+        names[operands[0]] = string::decodeSPIRVString(operands.slice(1));
+      break;
+    case spv::Op::OpDecorate:
+      if (operands.size() >= 2)
+        decorations[{operands[0], operands[1]}] =
+            operands.size() >= 3 ? operands[2] : 1u;
+      break;
+    case spv::Op::OpMemberDecorate: {
+      if (operands.size() < 3)
+        break;
+      auto &layouts = memberLayouts[operands[0]];
+      if (layouts.size() <= operands[1])
+        layouts.resize(operands[1] + 1);
+      MemberLayout &layout = layouts[operands[1]];
+      switch (static_cast<spv::Decoration>(operands[2])) {
+      case spv::Decoration::Offset:
+        if (operands.size() >= 4)
+          layout.offset = operands[3];
+        break;
+      case spv::Decoration::MatrixStride:
+        if (operands.size() >= 4)
+          layout.matrixStride = operands[3];
+        break;
+      case spv::Decoration::RowMajor:
+        layout.rowMajor = true;
+        break;
+      default:
+        break;
+      }
+      break;
+    }
+    case spv::Op::OpConstant:
+    case spv::Op::OpSpecConstant:
+      if (operands.size() >= 3)
+        constants[operands[1]] = operands[2];
+      break;
+    case spv::Op::OpVariable:
+      if (operands.size() < 3)
+        return false;
+      variables.push_back({operands[1], operands[0],
+                           static_cast<spv::StorageClass>(operands[2])});
+      break;
+    case spv::Op::OpFunction:
+      // Everything the blob needs is declared before the first function.
+      return true;
+    default:
+      if (isTypeDeclaration(opcode)) {
+        if (operands.empty())
+          return false;
+        TypeDecl &type = types[operands[0]];
+        type.opcode = opcode;
+        type.operands.clear();
+        type.operands.append(operands.begin() + 1, operands.end());
+        if (type.operands.size() < getMinTypeOperandCount(opcode))
+          return false;
+      }
+      break;
+    }
+  }
+  return true;
+}
+
+const TypeDecl *ModuleInfo::getType(uint32_t id) const {
+  auto it = types.find(id);
+  return it == types.end() ? nullptr : &it->second;
+}
+
+uint32_t ModuleInfo::getConstant(uint32_t id) const {
+  auto it = constants.find(id);
+  return it == constants.end() ? 0 : it->second;
+}
+
+uint32_t ModuleInfo::getDecoration(uint32_t id,
+                                   spv::Decoration decoration) const {
+  auto it = decorations.find({id, static_cast<uint32_t>(decoration)});
+  return it == decorations.end() ? kNone : it->second;
+}
+
+uint32_t ModuleInfo::getSizeInBytes(uint32_t typeId,
+                                    const MemberLayout &layout) const {
+  const TypeDecl *type = getType(typeId);
+  if (!type)
+    return 0;
+
+  switch (type->opcode) {
+  case spv::Op::OpTypeBool:
+    return 4;
+  case spv::Op::OpTypeInt:
+  case spv::Op::OpTypeFloat:
+    return type->operands[0] / 8;
+  case spv::Op::OpTypeVector:
+    return type->operands[1] * getSizeInBytes(type->operands[0], layout);
+  case spv::Op::OpTypeMatrix: {
+    const uint32_t columnCount = type->operands[1];
+    if (layout.matrixStride == 0)
+      return columnCount * getSizeInBytes(type->operands[0], layout);
+    if (!layout.rowMajor)
+      return columnCount * layout.matrixStride;
+    const TypeDecl *columnType = getType(type->operands[0]);
+    return columnType && columnType->opcode == spv::Op::OpTypeVector
+               ? columnType->operands[1] * layout.matrixStride
+               : 0;
+  }
+  case spv::Op::OpTypeArray: {
+    uint32_t stride = getDecoration(typeId, spv::Decoration::ArrayStride);
+    if (stride == kNone)
+      stride = getSizeInBytes(type->operands[0], layout);
+    return getConstant(type->operands[1]) * stride;
+  }
+  case spv::Op::OpTypeStruct:
+    return getStructSizeInBytes(typeId);
+  case spv::Op::OpTypePointer:
+    return 8;
+  default:
+    // Runtime arrays and opaque types do not contribute a fixed size.
+    return 0;
+  }
+}
+
+uint32_t ModuleInfo::getStructSizeInBytes(uint32_t structId) const {
+  const TypeDecl *type = getType(structId);
+  if (!type)
+    return 0;
+
+  auto layoutsIt = memberLayouts.find(structId);
+  uint32_t size = 0;
+  for (uint32_t i = 0; i < type->operands.size(); ++i) {
+    MemberLayout layout;
+    if (layoutsIt != memberLayouts.end() && i < layoutsIt->second.size())
+      layout = layoutsIt->second[i];
+    size = std::max(size,
+                    layout.offset + getSizeInBytes(type->operands[i], layout));
+  }
+  return size;
+}
+
+const TypeDecl *ModuleInfo::getImageType(const TypeDecl *type) const {
+  if (type && type->opcode == spv::Op::OpTypeSampledImage)
+    type = getType(type->operands[0]);
+  return type && type->opcode == spv::Op::OpTypeImage ? type : nullptr;
+}
+
+ReflectionDescriptorKind
+ModuleInfo::getDescriptorKind(spv::StorageClass storageClass,
+                              uint32_t typeId) const {
+  if (storageClass == spv::StorageClass::PushConstant ||
+      storageClass == spv::StorageClass::ShaderRecordBufferKHR)
+    return ReflectionDescriptorKind::None;
+
+  const TypeDecl *type = getType(typeId);
+  if (!type)
+    return ReflectionDescriptorKind::None;
+
+  switch (type->opcode) {
+  case spv::Op::OpTypeSampler:
+    return ReflectionDescriptorKind::Sampler;
+  case spv::Op::OpTypeSampledImage:
+    return ReflectionDescriptorKind::CombinedImageSampler;
+  case spv::Op::OpTypeImage: {
+    // Operands: sampled type, Dim, Depth, Arrayed, MS, Sampled, format.
+    const auto dim = static_cast<spv::Dim>(type->operands[1]);
+    const bool isStorage = type->operands[5] == 2;
+    if (dim == spv::Dim::SubpassData)
+      return ReflectionDescriptorKind::InputAttachment;
+    if (dim == spv::Dim::Buffer)
+      return isStorage ? ReflectionDescriptorKind::StorageTexelBuffer
+                       : ReflectionDescriptorKind::UniformTexelBuffer;
+    return isStorage ? ReflectionDescriptorKind::StorageImage
+                     : ReflectionDescriptorKind::SampledImage;
+  }
+  case spv::Op::OpTypeAccelerationStructureKHR:
+    return ReflectionDescriptorKind::AccelerationStructure;
+  case spv::Op::OpTypeStruct:
+    // Before SPIR-V 1.3, storage buffers are Uniform BufferBlocks.
+    if (storageClass == spv::StorageClass::StorageBuffer ||
+        getDecoration(typeId, spv::Decoration::BufferBlock) != kNone)
+      return ReflectionDescriptorKind::StorageBuffer;
+    return ReflectionDescriptorKind::UniformBuffer;
+  default:
+    return ReflectionDescriptorKind::None;
+  }
+}
+
+void ModuleInfo::writeResource(const Variable &var,
+                               std::vector<uint32_t> *blob) const {
+  blob->push_back(static_cast<uint32_t>(var.storageClass));
+  blob->push_back(getDecoration(var.id, spv::Decoration::DescriptorSet));
+  blob->push_back(getDecoration(var.id, spv::Decoration::Binding));
+
+  // Look through the pointer and the outermost array to the descriptor type.
+  const TypeDecl *pointerType = getType(var.pointerType);
+  uint32_t typeId = pointerType ? pointerType->operands[1] : 0;
+  uint32_t arraySize = 1;
+  const TypeDecl *type = getType(typeId);
+  if (type && type->opcode == spv::Op::OpTypeArray) {
+    arraySize = getConstant(type->operands[1]);
+    typeId = type->operands[0];
+  } else if (type && type->opcode == spv::Op::OpTypeRuntimeArray) {
+    arraySize = 0;
+    typeId = type->operands[0];
+  }
+  type = getType(typeId);
+  blob->push_back(type ? static_cast<uint32_t>(type->opcode) : 0);
+  blob->push_back(
+      static_cast<uint32_t>(getDescriptorKind(var.storageClass, typeId)));
+  const TypeDecl *imageType = getImageType(type);
+  blob->push_back(imageType ? imageType->operands[1] : kNone);
+  blob->push_back(arraySize);
+
+  const bool isBlock =
+      type && type->opcode == spv::Op::OpTypeStruct &&
+      (getDecoration(typeId, spv::Decoration::Block) != kNone ||
+       getDecoration(typeId, spv::Decoration::BufferBlock) != kNone);
+  if (isBlock) {
+    blob->push_back(getStructSizeInBytes(typeId));
+    blob->push_back(static_cast<uint32_t>(type->operands.size()));
+    auto layoutsIt = memberLayouts.find(typeId);
+    for (uint32_t i = 0; i < type->operands.size(); ++i) {
+      const bool hasLayout =
+          layoutsIt != memberLayouts.end() && i < layoutsIt->second.size();
+      blob->push_back(hasLayout ? layoutsIt->second[i].offset : 0);
+    }
+  } else {
+    blob->push_back(0);
+    blob->push_back(0);
+  }
+
+  auto nameIt = names.find(var.id);
+  writeString(nameIt == names.end() ? "" : nameIt->second, blob);
+}
+
+void ModuleInfo::write(std::vector<uint32_t> *blob) const {
+  blob->clear();
+  blob->push_back(kReflectionBlobMagic);
+  blob->push_back(kReflectionBlobVersion);
+  blob->push_back(static_cast<uint32_t>(entryPoints.size()));
+  const size_t resourceCountIndex = blob->size();
+  blob->push_back(0);
+
+  llvm::DenseMap<uint32_t, const Variable *> idToVariable;
+  for (const auto &var : variables)
+    idToVariable[var.id] = &var;
+
+  for (const auto &entryPoint : entryPoints) {
+    blob->push_back(entryPoint.executionModel);
+
+    std::array<uint32_t, 3> localSize = {{0, 0, 0}};
+    auto sizeIt = localSizes.find(entryPoint.function);
+    if (sizeIt != localSizes.end()) {
+      localSize = sizeIt->second;
+    } else {
+      auto sizeIdIt = localSizeIds.find(entryPoint.function);
+      if (sizeIdIt != localSizeIds.end())
+        for (uint32_t i = 0; i < 3; ++i)
+          localSize[i] = getConstant(sizeIdIt->second[i]);
+    }
+    blob->insert(blob->end(), localSize.begin(), localSize.end());
+
+    writeString(entryPoint.name, blob);
+
+    blob->push_back(static_cast<uint32_t>(entryPoint.interfaces.size()));
+    for (uint32_t id : entryPoint.interfaces) {
+      auto varIt = idToVariable.find(id);
+      blob->push_back(varIt == idToVariable.end()
+                          ? kNone
+                          : static_cast<uint32_t>(varIt->second->storageClass));
+      blob->push_back(getDecoration(id, spv::Decoration::Location));
+      blob->push_back(getDecoration(id, spv::Decoration::BuiltIn));
+    }
+  }
+
+  uint32_t resourceCount = 0;
+  for (const auto &var : variables) {
+    if (!isResourceStorageClass(var.storageClass))
+      continue;
+    writeResource(var, blob);
+    ++resourceCount;
+  }
+  (*blob)[resourceCountIndex] = resourceCount;
+}
+
+} // namespace
+
+bool writeReflectionBlob(llvm::ArrayRef<uint32_t> module,
+                         std::vector<uint32_t> *blob) {
+  assert(blob);
+  ModuleInfo info;
+  if (!info.parse(module))
+    return false;
+  info.write(blob);
+  return true;
+}
+
+} // end namespace spirv
+} // end namespace clang
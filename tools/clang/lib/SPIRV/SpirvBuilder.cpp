@@ -11,6 +11,7 @@
 #include "CapabilityVisitor.h"
 #include "DebugTypeVisitor.h"
 #include "EmitVisitor.h"
+#include "FusedVisitor.h"
 #include "LiteralTypeVisitor.h"
 #include "LowerTypeVisitor.h"
 #include "NonUniformVisitor.h"
@@ -1812,11 +1813,14 @@ std::vector<uint32_t> SpirvBuilder::takeModule() {
 
   mod->invokeVisitor(&literalTypeVisitor, true);
 
-  // Propagate NonUniform decorations
-  mod->invokeVisitor(&nonUniformVisitor);
-
-  // Lower types
-  mod->invokeVisitor(&lowerTypeVisitor);
+  // Propagate NonUniform decorations and lower types. NonUniform propagation
+  // only touches the NonUniform flags, which type lowering never reads, so
+  // both can share a single traversal of the module.
+  {
+    FusedVisitor fusedVisitor(context, spirvOptions,
+                              {&nonUniformVisitor, &lowerTypeVisitor});
+    mod->invokeVisitor(&fusedVisitor);
+  }
 
   // Generate debug types (if needed)
   if (spirvOptions.debugInfoRich) {
@@ -1827,11 +1831,14 @@ std::vector<uint32_t> SpirvBuilder::takeModule() {
     mod->invokeVisitor(&sortDebugInfoVisitor);
   }
 
-  // Add necessary capabilities and extensions
-  mod->invokeVisitor(&capabilityVisitor);
-
-  // Propagate RelaxedPrecision decorations
-  mod->invokeVisitor(&relaxedPrecisionVisitor);
+  // Add necessary capabilities and extensions, and propagate RelaxedPrecision
+  // decorations. Neither visitor reads what the other one writes, so they can
+  // share a single traversal of the module.
+  {
+    FusedVisitor fusedVisitor(context, spirvOptions,
+                              {&capabilityVisitor, &relaxedPrecisionVisitor});
+    mod->invokeVisitor(&fusedVisitor);
+  }
 
   // Propagate NoContraction decorations
   mod->invokeVisitor(&preciseVisitor, true);
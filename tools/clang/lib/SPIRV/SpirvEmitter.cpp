@@ -23,12 +23,14 @@
 #include "clang/AST/HlslTypes.h"
 #include "clang/AST/RecordLayout.h"
 #include "clang/SPIRV/AstTypeProbe.h"
+#include "clang/SPIRV/OptimizerCache.h"
 #include "clang/SPIRV/String.h"
 #include "clang/Sema/Sema.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/TimeProfiler.h"
 
 #ifdef SUPPORT_QUERY_GIT_COMMIT_INFO
 #include "clang/Basic/Version.h"
@@ -564,6 +566,55 @@ const StructType *lowerStructType(const SpirvCodeGenOptions &spirvOptions,
   return output;
 }
 
+// Removes the NonSemantic.Shader.DebugInfo.100 instructions and their import
+// from the SPIR-V module |mod|. Their results are only used by other debug
+// instructions, so the module stays valid. SPV_KHR_non_semantic_info is also
+// removed if no other non-semantic instruction set is imported.
+void removeShaderDebugInfoInstructions(std::vector<uint32_t> *mod) {
+  const size_t kHeaderSize = 5;
+  const char *kDebugInfoSet = "NonSemantic.Shader.DebugInfo.100";
+  uint32_t debugInfoSetId = 0;
+  bool hasOtherNonSemanticSets = false;
+  for (size_t i = kHeaderSize; i < mod->size();) {
+    const uint32_t wordCount = (*mod)[i] >> spv::WordCountShift;
+    if (wordCount == 0 || i + wordCount > mod->size())
+      return;
+    const auto opcode = static_cast<spv::Op>((*mod)[i] & spv::OpCodeMask);
+    if (opcode == spv::Op::OpExtInstImport && wordCount > 2) {
+      const std::string setName = string::decodeSPIRVString(
+          llvm::ArrayRef<uint32_t>(*mod).slice(i + 2, wordCount - 2));
+      if (setName == kDebugInfoSet)
+        debugInfoSetId = (*mod)[i + 1];
+      else if (llvm::StringRef(setName).startswith("NonSemantic."))
+        hasOtherNonSemanticSets = true;
+    }
+    i += wordCount;
+  }
+  if (!debugInfoSetId)
+    return;
+
+  size_t out = kHeaderSize;
+  for (size_t i = kHeaderSize; i < mod->size();) {
+    const uint32_t wordCount = (*mod)[i] >> spv::WordCountShift;
+    const auto opcode = static_cast<spv::Op>((*mod)[i] & spv::OpCodeMask);
+    bool remove = false;
+    if (opcode == spv::Op::OpExtInst)
+      remove = wordCount > 3 && (*mod)[i + 3] == debugInfoSetId;
+    else if (opcode == spv::Op::OpExtInstImport)
+      remove = (*mod)[i + 1] == debugInfoSetId;
+    else if (opcode == spv::Op::OpExtension && !hasOtherNonSemanticSets)
+      remove = string::decodeSPIRVString(llvm::ArrayRef<uint32_t>(*mod).slice(
+                   i + 1, wordCount - 1)) == "SPV_KHR_non_semantic_info";
+    if (!remove) {
+      std::copy(mod->begin() + i, mod->begin() + i + wordCount,
+                mod->begin() + out);
+      out += wordCount;
+    }
+    i += wordCount;
+  }
+  mod->resize(out);
+}
+
 } // namespace
 
 SpirvEmitter::SpirvEmitter(CompilerInstance &ci)
@@ -682,8 +733,29 @@ SpirvEmitter::SpirvEmitter(CompilerInstance &ci)
   }
 }
 
-std::vector<SpirvVariable *>
-SpirvEmitter::getInterfacesForEntryPoint(SpirvFunction *entryPoint) {
+SpirvEmitter::ModuleInterfaceVars
+SpirvEmitter::collectModuleInterfaceVariables() {
+  ModuleInterfaceVars moduleVars;
+  if (!featureManager.isTargetEnvVulkan1p1Spirv1p4OrAbove())
+    return moduleVars;
+
+  uint32_t position = 0;
+  for (auto *moduleVar : spvBuilder.getModule()->getVariables()) {
+    if (moduleVar->getStorageClass() != spv::StorageClass::Input &&
+        moduleVar->getStorageClass() != spv::StorageClass::Output) {
+      if (auto *varEntry =
+              declIdMapper.getRayTracingStageVarEntryFunction(moduleVar))
+        moduleVars.byEntryFunction[varEntry].emplace_back(position, moduleVar);
+      else
+        moduleVars.shared.emplace_back(position, moduleVar);
+    }
+    ++position;
+  }
+  return moduleVars;
+}
+
+std::vector<SpirvVariable *> SpirvEmitter::getInterfacesForEntryPoint(
+    SpirvFunction *entryPoint, const ModuleInterfaceVars &moduleVars) {
   auto stageVars = declIdMapper.collectStageVars(entryPoint);
   if (!featureManager.isTargetEnvVulkan1p1Spirv1p4OrAbove())
     return stageVars;
@@ -696,17 +768,18 @@ SpirvEmitter::getInterfacesForEntryPoint(SpirvFunction *entryPoint) {
   // declIdMapper.collectStageVars() to collect them.
   llvm::SetVector<SpirvVariable *> interfaces(stageVars.begin(),
                                               stageVars.end());
-  for (auto *moduleVar : spvBuilder.getModule()->getVariables()) {
-    if (moduleVar->getStorageClass() != spv::StorageClass::Input &&
-        moduleVar->getStorageClass() != spv::StorageClass::Output) {
-      if (auto *varEntry =
-              declIdMapper.getRayTracingStageVarEntryFunction(moduleVar)) {
-        if (varEntry != entryPoint)
-          continue;
-      }
-      interfaces.insert(moduleVar);
-    }
-  }
+  // Only this entry point's own ray tracing stage variables are looked at, and
+  // they are merged with the shared ones in module order.
+  std::vector<ModuleInterfaceVar> entryVars(moduleVars.shared);
+  auto it = moduleVars.byEntryFunction.find(entryPoint);
+  if (it != moduleVars.byEntryFunction.end()) {
+    entryVars.insert(entryVars.end(), it->second.begin(), it->second.end());
+    std::inplace_merge(entryVars.begin(),
+                       entryVars.begin() + moduleVars.shared.size(),
+                       entryVars.end(), llvm::less_first());
+  }
+  for (const auto &moduleVar : entryVars)
+    interfaces.insert(moduleVar.second);
   std::vector<SpirvVariable *> interfacesInVector;
   interfacesInVector.reserve(interfaces.size());
   for (auto *interface : interfaces) {
@@ -753,7 +826,13 @@ void SpirvEmitter::HandleTranslationUnit(ASTContext &context) {
   for (auto *decl : tu->decls()) {
     if (auto *funcDecl = dyn_cast<FunctionDecl>(decl)) {
       if (spvContext.isLib()) {
-        if (const auto *shaderAttr = funcDecl->getAttr<HLSLShaderAttr>()) {
+        const auto *shaderAttr = funcDecl->getAttr<HLSLShaderAttr>();
+        // With -fspv-entry-points, each module only has the entry point it is
+        // translated for.
+        if (shaderAttr && !spirvOptions.entryPoints.empty() &&
+            funcDecl->getName() != hlslEntryFunctionName)
+          shaderAttr = nullptr;
+        if (shaderAttr) {
           // If we are compiling as a library then add everything that has a
           // ShaderAttr.
           addFunctionToWorkQueue(getShaderModelKind(shaderAttr->getStage()),
@@ -799,6 +878,10 @@ void SpirvEmitter::HandleTranslationUnit(ASTContext &context) {
   // 'shader' attribute, and must therefore be entry functions.
   assert(numEntryPoints <= workQueue.size());
 
+  // The module-scope variables are the same for every entry point, so look
+  // them up once instead of once per entry point of a library.
+  const auto moduleInterfaceVars = collectModuleInterfaceVariables();
+
   for (uint32_t i = 0; i < numEntryPoints; ++i) {
     // TODO: assign specific StageVars w.r.t. to entry point
     const FunctionInfo *entryInfo = workQueue[i];
@@ -808,7 +891,8 @@ void SpirvEmitter::HandleTranslationUnit(ASTContext &context) {
             entryInfo->shaderModelKind,
             featureManager.isExtensionEnabled(Extension::EXT_mesh_shader)),
         entryInfo->entryFunction, getEntryPointName(entryInfo),
-        getInterfacesForEntryPoint(entryInfo->entryFunction));
+        getInterfacesForEntryPoint(entryInfo->entryFunction,
+                                   moduleInterfaceVars));
   }
 
   // Add Location decorations to stage input/output variables.
@@ -941,6 +1025,37 @@ void SpirvEmitter::HandleTranslationUnit(ASTContext &context) {
     }
   }
 
+  // Derive the stripped module from the debug-rich one, which is kept around
+  // as a separate output. This is much cheaper than a second compilation.
+  if (spirvOptions.stripDebugInfo) {
+    spirvOptions.debugModule = m;
+    std::string messages;
+    if (!spirvToolsStripDebugInfo(&m, &messages)) {
+      emitFatalError("failed to strip debug info from SPIR-V: %0", {})
+          << messages;
+      emitNote("please file a bug report on "
+               "https://github.com/Microsoft/DirectXShaderCompiler/issues "
+               "with source code if possible",
+               {});
+      return;
+    }
+    if (!spirvOptions.disableValidation && !spirvToolsValidate(&m, &messages)) {
+      emitFatalError("stripped SPIR-V is invalid: %0", {}) << messages;
+      emitNote("please file a bug report on "
+               "https://github.com/Microsoft/DirectXShaderCompiler/issues "
+               "with source code if possible",
+               {});
+      return;
+    }
+  }
+
+  // With -fspv-entry-points, the module of each entry point is returned
+  // separately.
+  if (!spirvOptions.entryPoints.empty()) {
+    spirvOptions.entryPointModules.push_back(std::move(m));
+    return;
+  }
+
   theCompilerInstance.getOutStream()->write(
       reinterpret_cast<const char *>(m.data()), m.size() * 4);
 }
@@ -14241,6 +14356,35 @@ SpirvEmitter::createFunctionScopeTempFromParameter(const ParmVarDecl *param) {
   return tempVar;
 }
 
+bool SpirvEmitter::runSpirvToolsOptimizer(
+    spvtools::Optimizer &optimizer, const spvtools::OptimizerOptions &options,
+    std::vector<uint32_t> *mod, llvm::StringRef stage) {
+  llvm::TimeTraceScope timeScope("SPIR-V Optimizer", stage);
+
+  if (!spirvOptions.timeReport)
+    return optimizer.Run(mod->data(), mod->size(), mod, options);
+
+  std::string passTimes;
+  llvm::raw_string_ostream passTimesOS(passTimes);
+  string::RawOstreamBuf passTimesBuf(passTimesOS);
+  std::ostream passTimesStream(&passTimesBuf);
+  optimizer.SetTimeReport(&passTimesStream);
+
+  const size_t wordsBefore = mod->size();
+  const bool success = optimizer.Run(mod->data(), mod->size(), mod, options);
+  passTimesOS.flush();
+  // SPIRV-Tools only reports pass times when built with SPIRV_TIMER_ENABLED.
+  if (passTimes.empty())
+    passTimes = "Per-pass times are not available in this build.\n";
+
+  llvm::raw_string_ostream reportOS(spirvOptions.optimizerTimeReport);
+  reportOS << "===-- SPIR-V " << stage << ": " << wordsBefore << " -> "
+           << mod->size() << " words --===\n"
+           << passTimes << "\n";
+  reportOS.flush();
+  return success;
+}
+
 bool SpirvEmitter::spirvToolsTrimCapabilities(std::vector<uint32_t> *mod,
                                               std::string *messages) {
   spvtools::Optimizer optimizer(featureManager.getTargetEnv());
@@ -14260,111 +14404,180 @@ bool SpirvEmitter::spirvToolsTrimCapabilities(std::vector<uint32_t> *mod,
 
   optimizer.RegisterPass(spvtools::CreateTrimCapabilitiesPass());
 
-  return optimizer.Run(mod->data(), mod->size(), mod, options);
+  return runSpirvToolsOptimizer(optimizer, options, mod, "capability trimming");
 }
 
-bool SpirvEmitter::spirvToolsOptimize(std::vector<uint32_t> *mod,
-                                      std::string *messages) {
+bool SpirvEmitter::spirvToolsStripDebugInfo(std::vector<uint32_t> *mod,
+                                            std::string *messages) {
   spvtools::Optimizer optimizer(featureManager.getTargetEnv());
   optimizer.SetMessageConsumer(
       [messages](spv_message_level_t /*level*/, const char * /*source*/,
                  const spv_position_t & /*position*/,
                  const char *message) { *messages += message; });
 
+  spvtools::OptimizerOptions options;
+  options.set_run_validator(false);
+  options.set_preserve_bindings(spirvOptions.preserveBindings);
+
+  // StripDebugInfoPass keeps the OpStrings that non-semantic instructions
+  // use, and does not remove the NonSemantic.Shader.DebugInfo.100
+  // instructions in function bodies, so remove those first. Only debug
+  // instructions are stripped: non-semantic reflection decorations requested
+  // via -fspv-reflect are kept.
+  removeShaderDebugInfoInstructions(mod);
+  optimizer.RegisterPass(spvtools::CreateStripDebugInfoPass());
+  optimizer.RegisterPass(spvtools::CreateCompactIdsPass());
+
+  return runSpirvToolsOptimizer(optimizer, options, mod,
+                                "debug info stripping");
+}
+
+bool SpirvEmitter::runCachedSpirvToolsOptimizer(
+    const std::string &recipe,
+    llvm::function_ref<bool(spvtools::Optimizer &)> registerPasses,
+    std::vector<uint32_t> *mod, std::string *messages, llvm::StringRef stage) {
+  OptimizerCache *cache = spirvOptions.optimizerCache.get();
+  std::unique_ptr<spvtools::Optimizer> optimizer;
+  if (cache)
+    optimizer = cache->take(recipe);
+  const bool registered = optimizer != nullptr;
+  if (!registered)
+    optimizer.reset(new spvtools::Optimizer(featureManager.getTargetEnv()));
+
+  optimizer->SetMessageConsumer(
+      [messages](spv_message_level_t /*level*/, const char * /*source*/,
+                 const spv_position_t & /*position*/,
+                 const char *message) { *messages += message; });
+
   string::RawOstreamBuf printAllBuf(llvm::errs());
   std::ostream printAllOS(&printAllBuf);
-  if (spirvOptions.printAll)
-    optimizer.SetPrintAll(&printAllOS);
+  optimizer->SetPrintAll(spirvOptions.printAll ? &printAllOS : nullptr);
+
+  if (!registered && !registerPasses(*optimizer))
+    return false;
 
   spvtools::OptimizerOptions options;
   options.set_run_validator(false);
   options.set_preserve_bindings(spirvOptions.preserveBindings);
 
-  if (spirvOptions.optConfig.empty()) {
-    // Add performance passes.
-    optimizer.RegisterPerformancePasses(spirvOptions.preserveInterface);
+  if (!runSpirvToolsOptimizer(*optimizer, options, mod, stage))
+    return false;
 
-    // Add propagation of volatile semantics passes.
-    optimizer.RegisterPass(spvtools::CreateSpreadVolatileSemanticsPass());
+  // Only keep optimizers that ran successfully, and don't let them keep
+  // pointers into this compilation.
+  if (cache) {
+    optimizer->SetMessageConsumer(
+        [](spv_message_level_t, const char *, const spv_position_t &,
+           const char *) {});
+    optimizer->SetPrintAll(nullptr);
+    optimizer->SetTimeReport(nullptr);
+    cache->put(recipe, std::move(optimizer));
+  }
+  return true;
+}
 
-    // Add compact ID pass.
-    optimizer.RegisterPass(spvtools::CreateCompactIdsPass());
-  } else {
+bool SpirvEmitter::spirvToolsOptimize(std::vector<uint32_t> *mod,
+                                      std::string *messages) {
+  std::string recipe;
+  llvm::raw_string_ostream recipeOS(recipe);
+  recipeOS << "optimization," << (int)featureManager.getTargetEnv() << ','
+           << spirvOptions.preserveInterface;
+  for (const auto &f : spirvOptions.optConfig)
+    recipeOS << ',' << f;
+  recipeOS.flush();
+
+  auto registerPasses = [this](spvtools::Optimizer &optimizer) {
+    if (spirvOptions.optConfig.empty()) {
+      // Add performance passes.
+      optimizer.RegisterPerformancePasses(spirvOptions.preserveInterface);
+
+      // Add propagation of volatile semantics passes.
+      optimizer.RegisterPass(spvtools::CreateSpreadVolatileSemanticsPass());
+
+      // Add compact ID pass.
+      optimizer.RegisterPass(spvtools::CreateCompactIdsPass());
+      return true;
+    }
     // Command line options use llvm::SmallVector and llvm::StringRef, whereas
     // SPIR-V optimizer uses std::vector and std::string.
     std::vector<std::string> stdFlags;
     for (const auto &f : spirvOptions.optConfig)
       stdFlags.push_back(f.str());
-    if (!optimizer.RegisterPassesFromFlags(stdFlags))
-      return false;
-  }
+    return optimizer.RegisterPassesFromFlags(stdFlags);
+  };
 
-  return optimizer.Run(mod->data(), mod->size(), mod, options);
+  return runCachedSpirvToolsOptimizer(recipe, registerPasses, mod, messages,
+                                      "optimization");
 }
 
 bool SpirvEmitter::spirvToolsLegalize(std::vector<uint32_t> *mod,
                                       std::string *messages,
                                       const std::vector<DescriptorSetAndBinding>
                                           *dsetbindingsToCombineImageSampler) {
-  spvtools::Optimizer optimizer(featureManager.getTargetEnv());
-  optimizer.SetMessageConsumer(
-      [messages](spv_message_level_t /*level*/, const char * /*source*/,
-                 const spv_position_t & /*position*/,
-                 const char *message) { *messages += message; });
-
-  string::RawOstreamBuf printAllBuf(llvm::errs());
-  std::ostream printAllOS(&printAllBuf);
-  if (spirvOptions.printAll)
-    optimizer.SetPrintAll(&printAllOS);
-
-  spvtools::OptimizerOptions options;
-  options.set_run_validator(false);
-  options.set_preserve_bindings(spirvOptions.preserveBindings);
-  // Add interface variable SROA if the signature packing is enabled.
-  if (spirvOptions.signaturePacking) {
-    optimizer.RegisterPass(
-        spvtools::CreateInterfaceVariableScalarReplacementPass());
-  }
-  optimizer.RegisterLegalizationPasses(spirvOptions.preserveInterface);
-  // Add flattening of resources if needed.
-  if (spirvOptions.flattenResourceArrays ||
-      declIdMapper.requiresFlatteningCompositeResources()) {
-    optimizer.RegisterPass(
-        spvtools::CreateReplaceDescArrayAccessUsingVarIndexPass());
-    optimizer.RegisterPass(
-        spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
-    optimizer.RegisterPass(spvtools::CreateDescriptorScalarReplacementPass());
-    // ADCE should be run after desc_sroa in order to remove potentially
-    // illegal types such as structures containing opaque types.
-    optimizer.RegisterPass(
-        spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
-  }
-  if (dsetbindingsToCombineImageSampler &&
-      !dsetbindingsToCombineImageSampler->empty()) {
-    optimizer.RegisterPass(spvtools::CreateConvertToSampledImagePass(
-        *dsetbindingsToCombineImageSampler));
-    // ADCE should be run after combining images and samplers in order to
-    // remove potentially illegal types such as structures containing opaque
-    // types.
-    optimizer.RegisterPass(
-        spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
-  }
-  if (spirvOptions.reduceLoadSize) {
-    // The threshold must be bigger than 1.0 to reduce all possible loads.
-    optimizer.RegisterPass(spvtools::CreateReduceLoadSizePass(1.1));
-    // ADCE should be run after reduce-load-size pass in order to remove
-    // dead instructions.
-    optimizer.RegisterPass(
-        spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
-  }
-  optimizer.RegisterPass(spvtools::CreateReplaceInvalidOpcodePass());
-  optimizer.RegisterPass(spvtools::CreateCompactIdsPass());
-  optimizer.RegisterPass(spvtools::CreateSpreadVolatileSemanticsPass());
-  if (spirvOptions.fixFuncCallArguments) {
-    optimizer.RegisterPass(spvtools::CreateFixFuncCallArgumentsPass());
-  }
+  const bool flattenResources =
+      spirvOptions.flattenResourceArrays ||
+      declIdMapper.requiresFlatteningCompositeResources();
+
+  std::string recipe;
+  llvm::raw_string_ostream recipeOS(recipe);
+  recipeOS << "legalization," << (int)featureManager.getTargetEnv() << ','
+           << spirvOptions.preserveInterface << spirvOptions.signaturePacking
+           << flattenResources << spirvOptions.reduceLoadSize
+           << spirvOptions.fixFuncCallArguments;
+  if (dsetbindingsToCombineImageSampler)
+    for (const auto &dsetbinding : *dsetbindingsToCombineImageSampler)
+      recipeOS << ',' << dsetbinding.descriptor_set << ':'
+               << dsetbinding.binding;
+  recipeOS.flush();
+
+  auto registerPasses = [&](spvtools::Optimizer &optimizer) {
+    // Add interface variable SROA if the signature packing is enabled.
+    if (spirvOptions.signaturePacking) {
+      optimizer.RegisterPass(
+          spvtools::CreateInterfaceVariableScalarReplacementPass());
+    }
+    optimizer.RegisterLegalizationPasses(spirvOptions.preserveInterface);
+    // Add flattening of resources if needed.
+    if (flattenResources) {
+      optimizer.RegisterPass(
+          spvtools::CreateReplaceDescArrayAccessUsingVarIndexPass());
+      optimizer.RegisterPass(
+          spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
+      optimizer.RegisterPass(spvtools::CreateDescriptorScalarReplacementPass());
+      // ADCE should be run after desc_sroa in order to remove potentially
+      // illegal types such as structures containing opaque types.
+      optimizer.RegisterPass(
+          spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
+    }
+    if (dsetbindingsToCombineImageSampler &&
+        !dsetbindingsToCombineImageSampler->empty()) {
+      optimizer.RegisterPass(spvtools::CreateConvertToSampledImagePass(
+          *dsetbindingsToCombineImageSampler));
+      // ADCE should be run after combining images and samplers in order to
+      // remove potentially illegal types such as structures containing opaque
+      // types.
+      optimizer.RegisterPass(
+          spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
+    }
+    if (spirvOptions.reduceLoadSize) {
+      // The threshold must be bigger than 1.0 to reduce all possible loads.
+      optimizer.RegisterPass(spvtools::CreateReduceLoadSizePass(1.1));
+      // ADCE should be run after reduce-load-size pass in order to remove
+      // dead instructions.
+      optimizer.RegisterPass(
+          spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
+    }
+    optimizer.RegisterPass(spvtools::CreateReplaceInvalidOpcodePass());
+    optimizer.RegisterPass(spvtools::CreateCompactIdsPass());
+    optimizer.RegisterPass(spvtools::CreateSpreadVolatileSemanticsPass());
+    if (spirvOptions.fixFuncCallArguments) {
+      optimizer.RegisterPass(spvtools::CreateFixFuncCallArgumentsPass());
+    }
+    return true;
+  };
 
-  return optimizer.Run(mod->data(), mod->size(), mod, options);
+  return runCachedSpirvToolsOptimizer(recipe, registerPasses, mod, messages,
+                                      "legalization");
 }
 
 SpirvInstruction *
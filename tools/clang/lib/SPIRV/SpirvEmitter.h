@@ -37,6 +37,9 @@
 #include "DeclResultIdMapper.h"
 
 namespace spvtools {
+class Optimizer;
+class OptimizerOptions;
+
 namespace opt {
 
 // A struct for a pair of descriptor set and binding.
@@ -1148,10 +1151,30 @@ private:
                     SpirvInstruction *minLod, SpirvInstruction *residencyCodeId,
                     SourceLocation loc, SourceRange range = {});
 
+  /// A module-scope variable with its position in the module, so variables
+  /// from different lists can be put back in module order.
+  using ModuleInterfaceVar = std::pair<uint32_t, SpirvVariable *>;
+
+  /// The module-scope variables that must be listed in the 'Interface'
+  /// operands of OpEntryPoint in addition to the stage variables.
+  struct ModuleInterfaceVars {
+    /// Variables that any entry point may use.
+    std::vector<ModuleInterfaceVar> shared;
+    /// Ray tracing stage variables, by the entry function they belong to.
+    llvm::DenseMap<SpirvFunction *, std::vector<ModuleInterfaceVar>>
+        byEntryFunction;
+  };
+
+  /// \brief Returns the module-scope interface variables, indexed by the entry
+  /// function they are restricted to. This is empty before SPIR-V 1.4.
+  ModuleInterfaceVars collectModuleInterfaceVariables();
+
   /// \brief Returns OpVariable to be used as 'Interface' operands of
-  /// OpEntryPoint. entryPoint is the SpirvFunction for the OpEntryPoint.
+  /// OpEntryPoint. entryPoint is the SpirvFunction for the OpEntryPoint, and
+  /// moduleVars are the variables from collectModuleInterfaceVariables().
   std::vector<SpirvVariable *>
-  getInterfacesForEntryPoint(SpirvFunction *entryPoint);
+  getInterfacesForEntryPoint(SpirvFunction *entryPoint,
+                             const ModuleInterfaceVars &moduleVars);
 
   /// \brief Emits OpBeginInvocationInterlockEXT and add the appropriate
   /// execution mode, if it has not already been added.
@@ -1164,6 +1187,29 @@ private:
                               const clang::FunctionDecl *,
                               bool isEntryFunction);
 
+  /// \brief Runs the already configured |optimizer| on the given SPIR-V
+  /// module |mod|. When a time report is requested, the per-pass timings and
+  /// the module size before and after the run are appended to the report
+  /// under |stage|.
+  /// Returns true on success and false otherwise.
+  bool runSpirvToolsOptimizer(spvtools::Optimizer &optimizer,
+                              const spvtools::OptimizerOptions &options,
+                              std::vector<uint32_t> *mod,
+                              llvm::StringRef stage);
+
+  /// \brief Runs an optimizer whose passes are registered by |registerPasses|
+  /// on the given SPIR-V module |mod|, and gets the info/warning/error
+  /// messages via |messages|. |recipe| must identify everything the registered
+  /// passes depend on: the optimizer is taken from and returned to the
+  /// optimizer cache under it, so later compilations with the same recipe
+  /// don't register the passes again.
+  /// Returns true on success and false otherwise.
+  bool runCachedSpirvToolsOptimizer(
+      const std::string &recipe,
+      llvm::function_ref<bool(spvtools::Optimizer &)> registerPasses,
+      std::vector<uint32_t> *mod, std::string *messages,
+      llvm::StringRef stage);
+
   /// \brief Helper function to run SPIRV-Tools optimizer's performance passes.
   /// Runs the SPIRV-Tools optimizer on the given SPIR-V module |mod|, and
   /// gets the info/warning/error messages via |messages|.
@@ -1178,6 +1224,13 @@ private:
   bool spirvToolsTrimCapabilities(std::vector<uint32_t> *mod,
                                   std::string *messages);
 
+  /// \brief Calls SPIRV-Tools optimizer's debug info stripping pass followed
+  /// by id compaction on the given SPIR-V module |mod|, and returns
+  /// info/warning/error messages via |messages|.
+  /// Returns true on success and false otherwise.
+  bool spirvToolsStripDebugInfo(std::vector<uint32_t> *mod,
+                                std::string *messages);
+
   /// \brief Helper function to run SPIRV-Tools optimizer's legalization passes.
   /// Runs the SPIRV-Tools legalization on the given SPIR-V module |mod|, and
   /// gets the info/warning/error messages via |messages|. If
@@ -28,8 +28,8 @@ RWStructuredBuffer<T> t_output;
 
 // CHECK: [[row0:%[0-9]+]] = OpConstantComposite %v3float %float_0 %float_1 %float_2
 // CHECK: [[row1:%[0-9]+]] = OpConstantComposite %v3float %float_3 %float_4 %float_5
-// CHECK: [[mat:%[0-9]+]] = OpConstantComposite %mat2v3float %33 %34
-// CHECK: [[s:%[0-9]+]] = OpConstantComposite %S %35
+// CHECK: [[mat:%[0-9]+]] = OpConstantComposite %mat2v3float [[row0]] [[row1]]
+// CHECK: [[s:%[0-9]+]] = OpConstantComposite %S [[mat]]
 
 void main() {
   S s;
@@ -25,7 +25,7 @@ void main() {
 // CHECK:                           OpLoad %v4float %b
 // CHECK-NEXT:                      OpLoad %v4float %c
 // CHECK-NEXT: [[first_b_plus_c]] = OpFAdd %v4float
-// CHECK-NEXT:                      OpStore %a %29
+// CHECK-NEXT:                      OpStore %a [[first_b_plus_c]]
   a = b + c;
   
 // Even though this looks like the statement on line 52:
@@ -44,14 +44,14 @@ void main() {
 // This changes "r" which will later change "v". Precise.
 //
 // CHECK:      [[second_a_mul_b]] = OpFMul %v3float
-// CHECK-NEXT:                      OpStore %r %58
+// CHECK-NEXT:                      OpStore %r [[second_a_mul_b]]
   r = float3((float3)a * (float3)b);
 
 // Even though this looks identical to "a = b + c" above:
 // This can change the value of "a", BUT, this change will not affect "v". Not Precise.
 //
 // CHECK:      [[second_a_plus_b:%[0-9]+]] = OpFAdd %v4float
-// CHECK-NEXT:                            OpStore %a %61
+// CHECK-NEXT:                            OpStore %a [[second_a_plus_b]]
   a = b + c;
 
 // This can change "c" which can then change "s" which can then change "v". Precise.
@@ -65,7 +65,7 @@ void main() {
 // This changes "s" which will later change "v". Precise.
 //
 // CHECK:      [[c_mul_d]] = OpFMul %v3float
-// CHECK-NEXT:               OpStore %s %75
+// CHECK-NEXT:               OpStore %s [[c_mul_d]]
   s = float3((float3)c * (float3)d);
 
 // Even though this looks identical to "c = d + e" above:
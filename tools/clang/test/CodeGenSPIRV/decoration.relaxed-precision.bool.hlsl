@@ -27,7 +27,7 @@
 // CHECK:   [[compare_op]] = OpFOrdGreaterThan %bool [[a]] %float_0
 // CHECK:            [[b]] = OpLoad %v2float %b
 // CHECK: [[compare_op_2]] = OpFOrdGreaterThan %v2bool [[b]] {{%[0-9]+}}
-// CHECK:  [[any_op:%[0-9]+]] = OpAny %bool %26
+// CHECK:  [[any_op:%[0-9]+]] = OpAny %bool [[compare_op_2]]
 // CHECK:   [[or_op:%[0-9]+]] = OpLogicalOr %bool
 
 RWBuffer<float2> Buf;
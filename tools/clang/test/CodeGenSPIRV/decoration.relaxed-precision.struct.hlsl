@@ -72,7 +72,7 @@ void main() {
   min16uint j = foo(s.b);
 }
 
-// CHECK:            %foo = OpFunction %uint None %48
+// CHECK:            %foo = OpFunction %uint None {{%[0-9]+}}
 // CHECK:          %param = OpFunctionParameter %_ptr_Function_int
 min16uint foo(min12int param) {
 // CHECK: [[param_value]] = OpLoad %int %param
@@ -0,0 +1,39 @@
+// RUN: mkdir -p %t.dir
+// RUN: %dxc -T ps_6_0 -fspv-entry-points=PSMain,PSAlt -fcgl %s -spirv -Fo %t.dir/ps.spv
+// RUN: FileCheck --input-file=%t.dir/PSMain.spv %s --check-prefix=MAIN
+// RUN: FileCheck --input-file=%t.dir/PSAlt.spv %s --check-prefix=ALT
+
+// The object is the module of the first entry point.
+// RUN: FileCheck --input-file=%t.dir/ps.spv %s --check-prefix=MAIN
+
+// Each library module only has the entry point it was translated for.
+// RUN: %dxc -T lib_6_4 -fspv-entry-points=CSMain -fcgl %s -spirv -Fo %t.dir/lib.spv
+// RUN: FileCheck --input-file=%t.dir/CSMain.spv %s --check-prefix=LIB
+
+// RUN: not %dxc -T ps_6_0 -fspv-entry-points=PSMain,Missing -fcgl %s -spirv 2>&1 | FileCheck %s --check-prefix=MISSING
+// RUN: not %dxc -T ps_6_0 -fspv-entry-points=PSMain -fspv-entrypoint-name=main -fcgl %s -spirv 2>&1 | FileCheck %s --check-prefix=CONFLICT
+
+// MAIN:     PSMain
+// MAIN-NOT: PSAlt
+
+// ALT:      PSAlt
+// ALT-NOT:  PSMain
+
+// LIB:      CSMain
+// LIB-NOT:  CSOther
+
+// MISSING: entry point 'Missing' given with -fspv-entry-points is not defined
+
+// CONFLICT: -fspv-entry-points cannot be used together with -fspv-entrypoint-name
+
+float4 PSMain(float4 color : COLOR) : SV_TARGET { return color; }
+
+float4 PSAlt(float4 color : COLOR) : SV_TARGET { return color * 2; }
+
+[shader("compute")]
+[numthreads(1, 1, 1)]
+void CSMain() {}
+
+[shader("compute")]
+[numthreads(1, 1, 1)]
+void CSOther() {}
@@ -0,0 +1,18 @@
+// The SPIR-V optimizer timers are not implemented for Windows.
+// UNSUPPORTED: system-windows
+
+// RUN: %dxc -T ps_6_0 -E main -spirv -ftime-report %s | FileCheck %s
+
+// The SPIR-V optimizer runs report the module size before and after each run,
+// followed by the time taken by each of their passes.
+
+// CHECK:      ; ===-- SPIR-V optimization: {{[0-9]+}} -> {{[0-9]+}} words --===
+// CHECK-NEXT: ; {{ *}}PASS name{{ +}}CPU time{{ +}}WALL time
+// CHECK-NEXT: ; {{ *}}{{[^ ]+}}{{ +}}{{[0-9.]+}}
+// CHECK:      ; ===-- SPIR-V capability trimming: {{[0-9]+}} -> {{[0-9]+}} words --===
+// CHECK-NEXT: ; {{ *}}PASS name{{ +}}CPU time{{ +}}WALL time
+// CHECK-NEXT: ; {{ *}}trim-capabilities{{ +}}{{[0-9.]+}}
+
+float4 main(float4 color : COLOR) : SV_TARGET {
+  return color;
+}
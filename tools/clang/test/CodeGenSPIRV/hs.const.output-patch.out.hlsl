@@ -8,13 +8,13 @@ struct ControlPoint { float4 position : POSITION; };
 // CHECK: OpFunctionCall %void %HullConst %param_var_edge %param_var_inside %param_var_myFloat 
 // CHECK: [[edges:%[0-9]+]] = OpLoad %_arr_float_uint_3 %param_var_edge 
 // CHECK: [[addr:%[0-9]+]] = OpAccessChain %_ptr_Output_float %gl_TessLevelOuter %uint_0 
-// CHECK: [[val:%[0-9]+]] = OpCompositeExtract %float %66 0 
+// CHECK: [[val:%[0-9]+]] = OpCompositeExtract %float [[edges]] 0 
 // CHECK: OpStore [[addr]] [[val]]
 // CHECK: [[addr:%[0-9]+]] = OpAccessChain %_ptr_Output_float %gl_TessLevelOuter %uint_1 
-// CHECK: [[val:%[0-9]+]] = OpCompositeExtract %float %66 1 
+// CHECK: [[val:%[0-9]+]] = OpCompositeExtract %float [[edges]] 1 
 // CHECK: OpStore [[addr]] [[val]]
 // CHECK: [[addr:%[0-9]+]] = OpAccessChain %_ptr_Output_float %gl_TessLevelOuter %uint_2 
-// CHECK: [[val:%[0-9]+]] = OpCompositeExtract %float %66 2 
+// CHECK: [[val:%[0-9]+]] = OpCompositeExtract %float [[edges]] 2 
 // CHECK: OpStore [[addr]] [[val]]
 // CHECK: [[val:%[0-9]+]] = OpLoad %float %param_var_inside 
 // CHECK: [[addr:%[0-9]+]] = OpAccessChain %_ptr_Output_float %gl_TessLevelInner %uint_0 
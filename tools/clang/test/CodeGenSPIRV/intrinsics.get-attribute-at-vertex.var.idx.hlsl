@@ -12,8 +12,8 @@ float4 main(PSInput input) : SV_Target {
 // CHECK:   [[bc:%[0-9]+]] = OpBitcast %uint [[idx]]
 // CHECK:   [[ac:%[0-9]+]] = OpAccessChain %_ptr_Input_v4float %in_var_FPH [[bc]]
 // CHECK:    [[a:%[0-9]+]] = OpLoad %v4float [[ac]]
-// CHECK:   [[ac:%[0-9]+]] = OpAccessChain %_ptr_Input_v4float %in_var_FPH %21
-// CHECK:    [[b:%[0-9]+]] = OpLoad %v4float %25
+// CHECK:   [[ac:%[0-9]+]] = OpAccessChain %_ptr_Input_v4float %in_var_FPH [[uidx]]
+// CHECK:    [[b:%[0-9]+]] = OpLoad %v4float [[ac]]
 // CHECK:  [[add:%[0-9]+]] = OpFAdd %v4float [[a]] [[b]]
 // CHECK:                    OpStore %out_var_SV_Target [[add]]
   float4 a = GetAttributeAtVertex(input.fp_h, input.idx);
@@ -98,8 +98,8 @@ float4 main() : SV_Target {
 // CHECK:       [[bar:%[0-9]+]] = OpFunctionCall %S %bar
 // CHECK-NEXT:                 OpStore %temp_var_S_0 [[bar]]
 // CHECK-NEXT: [[ac:%[0-9]+]] = OpAccessChain %_ptr_Function__arr_float_uint_4 %temp_var_S_0 %int_5
-// CHECK-NEXT: [[ld:%[0-9]+]] = OpLoad %_arr_float_uint_4 %111
-// CHECK-NEXT:                 OpStore %temp_var__0 %112
+// CHECK-NEXT: [[ld:%[0-9]+]] = OpLoad %_arr_float_uint_4 [[ac]]
+// CHECK-NEXT:                 OpStore %temp_var__0 [[ld]]
 // CHECK-NEXT:                 OpAccessChain %_ptr_Function_float %temp_var__0 %int_1
     float4 val1 = bar().f[1] * baz().e[0];
 
@@ -127,7 +127,7 @@ void main() {
 
 // CHECK:      DebugLine [[src]] %uint_132 %uint_132 %uint_11 %uint_15
 // CHECK-NEXT: OpMatrixTimesScalar %mat2v2float
-// CHECK:      DebugLine %35 %uint_132 %uint_132 %uint_11 %uint_23
+// CHECK:      DebugLine [[src]] %uint_132 %uint_132 %uint_11 %uint_23
 // CHECK-NEXT: OpFAdd %v2float
   m2x2f = 2 * m2x2f + m2x2i;
 
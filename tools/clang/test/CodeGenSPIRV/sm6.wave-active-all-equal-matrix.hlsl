@@ -13,7 +13,7 @@ RWStructuredBuffer<S> values;
 void main(uint3 id: SV_DispatchThreadID) {
 
 // Each element of the matrix must be extracted, and be passed to OpGroupNonUniformAllEqual. 
-// CHECK: [[ld:%[a-zA-Z0-9_]+]] = OpLoad %mat2v2float %34
+// CHECK: [[ld:%[a-zA-Z0-9_]+]] = OpLoad %mat2v2float {{%[0-9]+}}
 
 // Process the first row.
 // CHECK: [[row_0:%[a-zA-Z0-9_]+]] = OpCompositeExtract %v2float [[ld]] 0
@@ -42,7 +42,7 @@ void main(uint3 id: SV_DispatchThreadID) {
 // Apply the `all` to the entire matrix.
 // CHECK: [[res_vec0:%[a-zA-Z0-9_]+]] = OpCompositeExtract %v2bool [[res_matrix]] 0
 // CHECK: [[all0:%[a-zA-Z0-9_]+]] = OpAll %bool [[res_vec0]]
-// CHECK: [[res_vec1:%[a-zA-Z0-9_]+]] = OpCompositeExtract %v2bool %53 1
+// CHECK: [[res_vec1:%[a-zA-Z0-9_]+]] = OpCompositeExtract %v2bool [[res_matrix]] 1
 // CHECK: [[all1:%[a-zA-Z0-9_]+]] = OpAll %bool [[res_vec1]]
 // CHECK: [[all_vec:%[a-zA-Z0-9_]+]] = OpCompositeConstruct %v2bool [[all0]] [[all1]]
 // CHECK: [[all:%[a-zA-Z0-9_]+]] = OpAll %bool [[all_vec]]
@@ -0,0 +1,25 @@
+// RUN: %dxc -T ps_6_0 -E main -spirv -fspv-debug=vulkan-with-source -Qstrip_debug %s | FileCheck %s
+// RUN: %dxc -T ps_6_0 -E main -spirv -fspv-debug=vulkan-with-source -Qstrip_debug %s -Fo %t.spv -Fd %t.dbg.spv
+// RUN: FileCheck --input-file=%t.dbg.spv %s --check-prefix=FD
+
+// The returned module has its debug info stripped. It is validated after
+// stripping, so the compile fails if the stripped module is invalid.
+// CHECK-NOT: NonSemantic.Shader.DebugInfo.100
+// CHECK-NOT: SPV_KHR_non_semantic_info
+// CHECK:     OpEntryPoint Fragment %{{[0-9]+}} "main"
+// CHECK-NOT: OpString
+// CHECK-NOT: OpName
+// CHECK-NOT: DebugSource
+// CHECK-NOT: OpLine
+// CHECK-NOT: NonSemantic.Shader.DebugInfo.100
+// CHECK-NOT: DebugScope
+// CHECK-NOT: DebugDeclare
+// CHECK-NOT: DebugLine
+
+// The debug-rich module it was derived from is returned as the PDB.
+// FD: NonSemantic.Shader.DebugInfo.100
+
+float4 main(float4 color : COLOR) : SV_TARGET {
+  float4 scaled = color * 2;
+  return scaled;
+}
@@ -1,5 +1,19 @@
 // RUN: not %dxc -T ps_6_0 -E main -spirv -Fd file.ext -fcgl  %s -spirv 2>&1 | FileCheck %s
 
+// -Fd writes the debug-rich module when debug info is stripped.
+// RUN: %dxc -T ps_6_0 -E main -spirv -fspv-debug=vulkan-with-source -Qstrip_debug -Fd %t.pdb %s 2>&1 | FileCheck %s --check-prefix=STRIP
+// RUN: FileCheck --input-file=%t.pdb %s --check-prefix=PDB
+
+// With a directory for -Fd, the debug-rich module is named after the input.
+// RUN: rm -rf %t.dir && mkdir -p %t.dir
+// RUN: %dxc -T ps_6_0 -E main -spirv -fspv-debug=vulkan-with-source -Qstrip_debug -Fd %t.dir/ %s
+// RUN: FileCheck --input-file=%t.dir/spirv.opt.fd.pdb %s --check-prefix=PDB
+
 void main() {}
 
 // CHECK: -Fd is not supported with -spirv
+
+// STRIP-NOT: not supported
+// STRIP:     OpEntryPoint Fragment %{{[0-9]+}} "main"
+
+// PDB: NonSemantic.Shader.DebugInfo.100
@@ -1,5 +1,19 @@
 // RUN: not %dxc -T ps_6_0 -E main -spirv -Fre file.ext -fcgl  %s -spirv 2>&1 | FileCheck %s
 
-void main() {}
+// -Fre writes the reflection blob when it is requested.
+// RUN: %dxc -T ps_6_0 -E main -spirv -fspv-reflect-blob -Fre %t.refl %s
+// RUN: FileCheck --input-file=%t.refl %s --check-prefix=BLOB
+
+Texture2D<float4> gTexture : register(t0);
+SamplerState gSampler : register(s0);
+
+float4 main(float2 uv : TEXCOORD) : SV_Target {
+  return gTexture.Sample(gSampler, uv);
+}
 
 // CHECK: -Fre is not supported with -spirv
+
+// BLOB: SPRF
+// BLOB: main
+// BLOB: gTexture
+// BLOB: gSampler
@@ -39,7 +39,7 @@ void main() {
 //CHECK-NEXT:                  OpStore [[c]] [[third]]
   c.Append(Third);
 
-//CHECK:          [[c_0:%[0-9]+]] = OpAccessChain %_ptr_Uniform_int %c %uint_0 %57
+//CHECK:          [[c_0:%[0-9]+]] = OpAccessChain %_ptr_Uniform_int %c %uint_0 {{%[0-9]+}}
 //CHECK-NEXT: [[third_0:%[0-9]+]] = OpLoad %int %Third
 //CHECK-NEXT:                  OpStore [[c_0]] [[third_0]]
   c.Append(Number::Third);
@@ -33,8 +33,8 @@ float main() : A {
 // CHECK-NEXT: [[tex2d1:%[0-9]+]] = OpLoad %type_2d_image %gTex2D
 // CHECK-NEXT: [[tex2d2:%[0-9]+]] = OpLoad %type_2d_image %gTex2D
 // CHECK-NEXT: [[sampl2:%[0-9]+]] = OpLoad %type_sampler %gSampler
-// CHECK-NEXT:  [[tex3d_1:%[0-9]+]] = OpCompositeExtract %type_3d_image %32 0
-// CHECK-NEXT: [[sampl1:%[0-9]+]] = OpCompositeExtract %type_sampler %32 1
+// CHECK-NEXT:  [[tex3d_1:%[0-9]+]] = OpCompositeExtract %type_3d_image [[tex3d_0]] 0
+// CHECK-NEXT: [[sampl1:%[0-9]+]] = OpCompositeExtract %type_sampler [[tex3d_0]] 1
 // CHECK-NEXT:  [[inner:%[0-9]+]] = OpCompositeConstruct %Inner [[tex3d_1]]
 // CHECK-NEXT:  [[comb1:%[0-9]+]] = OpCompositeConstruct %Combined1 [[inner]] [[sampl1]] [[tex2d1]] [[tex2d2]] [[sampl2]]
 // CHECK-NEXT:                   OpStore %comb1 [[comb1]]
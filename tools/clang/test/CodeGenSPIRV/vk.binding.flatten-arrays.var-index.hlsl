@@ -58,15 +58,15 @@ float4 main(uint instanceID : INSTANCEID, float2 texCoord : TEXCOORD) : SV_TARGE
 
 // CHECK: OpLoad %type_sampler %x_1_
 // CHECK: OpLoad %type_2d_image %y_0_
-// CHECK: OpImageSampleImplicitLod %v4float %59 [[texCoord]] None
+// CHECK: OpImageSampleImplicitLod %v4float {{%[0-9]+}} [[texCoord]] None
 
 // CHECK: OpLoad %type_sampler %x_1_
 // CHECK: OpLoad %type_2d_image %y_1_
-// CHECK: OpImageSampleImplicitLod %v4float %63 [[texCoord]] None
+// CHECK: OpImageSampleImplicitLod %v4float {{%[0-9]+}} [[texCoord]] None
 
 // CHECK: OpLoad %type_sampler %x_1_
 // CHECK: OpLoad %type_2d_image %y_2_
-// CHECK: OpImageSampleImplicitLod %v4float %67 [[texCoord]] None
+// CHECK: OpImageSampleImplicitLod %v4float {{%[0-9]+}} [[texCoord]] None
 
 // CHECK: OpPhi %v4float
 
@@ -0,0 +1,36 @@
+// RUN: %dxc -T ps_6_0 -E main -fvk-use-dx-layout -fcgl  %s -spirv | FileCheck %s
+
+// The lowered type of a struct is shared by every use with the same layout
+// rule. Both cbuffers must still be cloned, since the struct they contain
+// needs an array for its 1xN matrix member.
+
+// CHECK: %layout = OpTypeStruct %float {{%[a-zA-Z0-9_]+}} %float
+// CHECK: %type_buffer0 = OpTypeStruct %float %layout
+// CHECK: %type_buffer1 = OpTypeStruct %layout %float
+
+// CHECK: [[layout_clone:%[a-zA-Z0-9_]+]] = OpTypeStruct %float %v2float %float
+// CHECK: OpTypeStruct %float [[layout_clone]]{{$}}
+// CHECK: OpTypeStruct [[layout_clone]] %float
+
+struct layout {
+  float dummy0;
+  float1x2 foo;
+  float end;
+};
+
+cbuffer buffer0 {
+  float dummy1;
+  layout bar;
+};
+
+cbuffer buffer1 {
+  layout baz;
+  float end;
+};
+
+float4 main(float4 color : COLOR) : SV_TARGET
+{
+  color.x += bar.foo._12;
+  color.y += baz.foo._11 + end;
+  return color;
+}
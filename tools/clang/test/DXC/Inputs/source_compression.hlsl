@@ -0,0 +1,122 @@
+// Shader used to compare how well the source info part compresses at each
+// -Qsource_compression level. It needs enough text for the zlib levels to
+// make different choices, so it carries a handful of small, varied helpers.
+
+Texture2D<float4> g_albedo : register(t0);
+Texture2D<float4> g_normals : register(t1);
+Texture2D<float> g_occlusion : register(t2);
+SamplerState g_linearSampler : register(s0);
+
+cbuffer Frame : register(b0) {
+  float4x4 g_viewProjection;
+  float3 g_cameraPosition;
+  float g_time;
+  float3 g_lightDirection;
+  float g_exposure;
+  float4 g_fogColor;
+  float g_fogDensity;
+  float g_fogHeightFalloff;
+  uint g_debugMode;
+  uint g_frameIndex;
+};
+
+struct PSInput {
+  float4 position : SV_Position;
+  float3 worldPosition : POSITION;
+  float3 worldNormal : NORMAL;
+  float4 worldTangent : TANGENT;
+  float2 uv : TEXCOORD0;
+};
+
+// Unpacks a tangent-space normal from a two channel normal map.
+float3 UnpackNormal(float2 packed) {
+  float2 xy = packed * 2.0f - 1.0f;
+  float z = sqrt(saturate(1.0f - dot(xy, xy)));
+  return float3(xy, z);
+}
+
+// Moves a tangent-space normal into world space.
+float3 TangentToWorld(float3 n, float3 normal, float4 tangent) {
+  float3 bitangent = cross(normal, tangent.xyz) * tangent.w;
+  return normalize(n.x * tangent.xyz + n.y * bitangent + n.z * normal);
+}
+
+// Schlick's approximation of the Fresnel term.
+float3 FresnelSchlick(float cosTheta, float3 f0) {
+  return f0 + (1.0f - f0) * pow(1.0f - saturate(cosTheta), 5.0f);
+}
+
+// GGX normal distribution function.
+float DistributionGGX(float nDotH, float roughness) {
+  float a = roughness * roughness;
+  float a2 = a * a;
+  float denom = nDotH * nDotH * (a2 - 1.0f) + 1.0f;
+  return a2 / (3.14159265f * denom * denom);
+}
+
+// Smith's visibility term with the Schlick-GGX approximation.
+float GeometrySmith(float nDotV, float nDotL, float roughness) {
+  float k = (roughness + 1.0f) * (roughness + 1.0f) / 8.0f;
+  float gv = nDotV / (nDotV * (1.0f - k) + k);
+  float gl = nDotL / (nDotL * (1.0f - k) + k);
+  return gv * gl;
+}
+
+// Exponential height fog along the view ray.
+float3 ApplyFog(float3 color, float3 worldPosition) {
+  float3 toCamera = worldPosition - g_cameraPosition;
+  float distance = length(toCamera);
+  float heightTerm = exp(-g_fogHeightFalloff * max(worldPosition.y, 0.0f));
+  float fog = 1.0f - exp(-g_fogDensity * distance * heightTerm);
+  return lerp(color, g_fogColor.rgb, saturate(fog) * g_fogColor.a);
+}
+
+// Filmic tone mapping curve from Jim Hejl and Richard Burgess-Dawson.
+float3 ToneMap(float3 color) {
+  float3 x = max(0.0f, color * g_exposure - 0.004f);
+  return (x * (6.2f * x + 0.5f)) / (x * (6.2f * x + 1.7f) + 0.06f);
+}
+
+// Small ordered dither to hide banding in dark gradients.
+float Dither(float2 pixel) {
+  uint2 p = uint2(pixel) & 3;
+  uint index = p.x + p.y * 4 + (g_frameIndex & 3);
+  return (float(index & 15) / 16.0f - 0.5f) / 255.0f;
+}
+
+float4 main(PSInput input) : SV_Target {
+  float4 albedo = g_albedo.Sample(g_linearSampler, input.uv);
+  float4 packedNormal = g_normals.Sample(g_linearSampler, input.uv);
+  float occlusion = g_occlusion.Sample(g_linearSampler, input.uv);
+
+  float3 normal = TangentToWorld(UnpackNormal(packedNormal.xy),
+                                 normalize(input.worldNormal),
+                                 input.worldTangent);
+  float roughness = max(packedNormal.z, 0.04f);
+  float metallic = packedNormal.w;
+
+  float3 view = normalize(g_cameraPosition - input.worldPosition);
+  float3 light = normalize(-g_lightDirection);
+  float3 halfVector = normalize(view + light);
+  float nDotV = max(dot(normal, view), 1e-4f);
+  float nDotL = saturate(dot(normal, light));
+  float nDotH = saturate(dot(normal, halfVector));
+
+  float3 f0 = lerp(float3(0.04f, 0.04f, 0.04f), albedo.rgb, metallic);
+  float3 fresnel = FresnelSchlick(saturate(dot(halfVector, view)), f0);
+  float3 specular = DistributionGGX(nDotH, roughness) *
+                    GeometrySmith(nDotV, nDotL, roughness) * fresnel /
+                    (4.0f * nDotV * max(nDotL, 1e-4f));
+  float3 diffuse = (1.0f - fresnel) * (1.0f - metallic) * albedo.rgb /
+                   3.14159265f;
+  float3 color = (diffuse + specular) * nDotL + albedo.rgb * 0.03f * occlusion;
+
+  if (g_debugMode == 1)
+    color = normal * 0.5f + 0.5f;
+  else if (g_debugMode == 2)
+    color = float3(roughness, metallic, occlusion);
+
+  color = ToneMap(ApplyFog(color, input.worldPosition));
+  color += Dither(input.position.xy);
+  return float4(color, albedo.a);
+}
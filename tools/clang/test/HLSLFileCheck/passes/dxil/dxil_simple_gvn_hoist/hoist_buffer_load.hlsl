@@ -0,0 +1,20 @@
+// RUN: %dxc -E main -T ps_6_0 %s | FileCheck %s
+
+// Make sure identical buffer loads on both sides of a branch are merged into
+// a single load.
+
+// CHECK: call %dx.types.ResRet.f32 @dx.op.bufferLoad.f32(i32 68,
+// CHECK-NOT: call %dx.types.ResRet.f32 @dx.op.bufferLoad.f32(i32 68,
+// CHECK: ret void
+
+RWBuffer<float> buf;
+
+float main(uint i : I, float c : C) : SV_Target {
+  float r;
+  if (c > 0) {
+    r = buf[i] * 2;
+  } else {
+    r = buf[i] + 3;
+  }
+  return r;
+}
@@ -57,6 +57,11 @@ static cl::opt<bool> ListFiles("listfiles",
 static cl::opt<std::string> ExtractFile(
     "extractfile",
     cl::desc("Extract file from debug information (use '*' for all files)"));
+static cl::opt<std::string>
+    SourceStore("sourcestore",
+                cl::desc("Directory to read sources compiled with "
+                         "-Qsource_store from"),
+                cl::value_desc("directory"));
 
 static cl::opt<bool> DumpRootSig("dumprs", cl::desc("Dump root signature"),
                                  cl::init(false));
@@ -178,12 +183,21 @@ HRESULT DxaContext::FindModule(hlsl::DxilFourCC fourCC, IDxcBlob *pSource,
   return E_INVALIDARG;
 }
 
+static void SetSourceStore(IDxcPdbUtils *pPdbUtils) {
+  if (SourceStore.empty())
+    return;
+  CComPtr<IDxcPdbUtils3> pPdbUtils3;
+  IFT(pPdbUtils->QueryInterface(&pPdbUtils3));
+  IFT(pPdbUtils3->SetSourceStore(StringRefWide(SourceStore)));
+}
+
 void DxaContext::ListFiles() {
   CComPtr<IDxcBlobEncoding> pSource;
-  ReadFileIntoBlob(m_dxcSupport, StringRefWide(InputFilename), &pSource);
+  MapFileIntoBlob(StringRefWide(InputFilename), &pSource);
 
   CComPtr<IDxcPdbUtils> pPdbUtils;
   IFT(m_dxcSupport.CreateInstance(CLSID_DxcPdbUtils, &pPdbUtils));
+  SetSourceStore(pPdbUtils);
   IFT(pPdbUtils->Load(pSource));
 
   UINT32 uNumSources = 0;
@@ -198,10 +212,11 @@ void DxaContext::ListFiles() {
 
 bool DxaContext::ExtractFile(const char *pName) {
   CComPtr<IDxcBlobEncoding> pSource;
-  ReadFileIntoBlob(m_dxcSupport, StringRefWide(InputFilename), &pSource);
+  MapFileIntoBlob(StringRefWide(InputFilename), &pSource);
 
   CComPtr<IDxcPdbUtils> pPdbUtils;
   IFT(m_dxcSupport.CreateInstance(CLSID_DxcPdbUtils, &pPdbUtils));
+  SetSourceStore(pPdbUtils);
   IFT(pPdbUtils->Load(pSource));
 
   UINT32 uNumSources = 0;
@@ -226,7 +241,7 @@ bool DxaContext::ExtractFile(const char *pName) {
 
 bool DxaContext::ExtractPart(uint32_t PartKind, IDxcBlob **ppTargetBlob) {
   CComPtr<IDxcBlobEncoding> pSource;
-  ReadFileIntoBlob(m_dxcSupport, StringRefWide(InputFilename), &pSource);
+  MapFileIntoBlob(StringRefWide(InputFilename), &pSource);
   return ExtractPart(pSource, PartKind, ppTargetBlob);
 }
 
@@ -310,7 +325,7 @@ bool DxaContext::ExtractPart(const char *pName) {
 
 void DxaContext::ListParts() {
   CComPtr<IDxcBlobEncoding> pSource;
-  ReadFileIntoBlob(m_dxcSupport, StringRefWide(InputFilename), &pSource);
+  MapFileIntoBlob(StringRefWide(InputFilename), &pSource);
 
   CComPtr<IDxcContainerReflection> pReflection;
   IFT(m_dxcSupport.CreateInstance(CLSID_DxcContainerReflection, &pReflection));
@@ -369,7 +384,7 @@ void DxaContext::DumpRS() {
 void DxaContext::DumpRDAT() {
   CComPtr<IDxcBlob> pPart;
   CComPtr<IDxcBlobEncoding> pSource;
-  ReadFileIntoBlob(m_dxcSupport, StringRefWide(InputFilename), &pSource);
+  MapFileIntoBlob(StringRefWide(InputFilename), &pSource);
   if (pSource->GetBufferSize() < sizeof(hlsl::RDAT::RuntimeDataHeader)) {
     printf("Invalid input file, use binary DxilContainer or raw RDAT part.");
     return;
@@ -405,7 +420,7 @@ void DxaContext::DumpRDAT() {
 
 void DxaContext::DumpReflection() {
   CComPtr<IDxcBlobEncoding> pSource;
-  ReadFileIntoBlob(m_dxcSupport, StringRefWide(InputFilename), &pSource);
+  MapFileIntoBlob(StringRefWide(InputFilename), &pSource);
 
   CComPtr<IDxcContainerReflection> pReflection;
   IFT(m_dxcSupport.CreateInstance(CLSID_DxcContainerReflection, &pReflection));
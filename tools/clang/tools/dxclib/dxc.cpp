@@ -37,6 +37,7 @@
 //
 
 #include "dxc.h"
+#include "dxcserver.h"
 #include "dxc/Support/Global.h"
 #include "dxc/Support/Unicode.h"
 #include "dxc/Support/WinFunctions.h"
@@ -1397,20 +1398,13 @@ static LONG CALLBACK ExceptionFilter(PEXCEPTION_POINTERS pExceptionInfo) {
 }
 #endif
 
-#ifdef _WIN32
-int dxc::main(int argc, const wchar_t **argv_) {
-#else
-int dxc::main(int argc, const char **argv_) {
-#endif // _WIN32
+// Runs the console program once the thread malloc and the option table have
+// been initialized.
+template <typename TChar> static int RunDxc(int argc, const TChar **argv_) {
   const char *pStage = "Operation";
   int retVal = 0;
-  if (FAILED(DxcInitThreadMalloc()))
-    return 1;
-  DxcSetThreadMallocToDefault();
   try {
     pStage = "Argument processing";
-    if (initHlslOptTable())
-      throw std::bad_alloc();
 
     // Parse command line options.
     const OptTable *optionTable = getHlslOptTable();
@@ -1486,6 +1480,18 @@ int dxc::main(int argc, const char **argv_) {
       return 0;
     }
 
+    if (!dxcOpts.ServerSocket.empty() || !dxcOpts.ConnectSocket.empty()) {
+#ifdef _WIN32
+      fprintf(stderr, "dxc failed : --server and --connect are not supported "
+                      "on this platform.\n");
+      return 1;
+#else
+      // --connect was already handled by RunCompileClient.
+      pStage = "Compile server";
+      return RunCompileServer(dxcOpts.ServerSocket.str().c_str(), dxcSupport);
+#endif // _WIN32
+    }
+
     // TODO: implement all other actions.
     if (!dxcOpts.Preprocess.empty()) {
       pStage = "Preprocessing";
@@ -1576,3 +1582,30 @@ int dxc::main(int argc, const char **argv_) {
 
   return retVal;
 }
+
+#ifdef _WIN32
+int dxc::main(int argc, const wchar_t **argv_) {
+#else
+int dxc::main(int argc, const char **argv_) {
+#endif // _WIN32
+#ifndef _WIN32
+  // Forward the compilation to a compile server if one was requested.
+  int exitCode;
+  if (RunCompileClient(argc, argv_, &exitCode))
+    return exitCode;
+#endif // _WIN32
+  if (FAILED(DxcInitThreadMalloc()))
+    return 1;
+  DxcSetThreadMallocToDefault();
+  if (initHlslOptTable()) {
+    printf("Argument processing failed - out of memory.\n");
+    return 1;
+  }
+  return RunDxc(argc, argv_);
+}
+
+#ifndef _WIN32
+int dxc::RunForwardedCompilation(int argc, const char **argv_) {
+  return RunDxc(argc, argv_);
+}
+#endif // _WIN32
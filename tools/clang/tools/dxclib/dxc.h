@@ -31,6 +31,11 @@ void WriteDXILVersionInfo(llvm::raw_ostream &OS,
 int main(int argc, const wchar_t **argv_);
 #else
 int main(int argc, const char **argv_);
+
+// Runs a compilation forwarded to a compile server in a process forked from
+// the server. Unlike main, reuses the thread malloc and the option table that
+// the server's own invocation initialized.
+int RunForwardedCompilation(int argc, const char **argv_);
 #endif // _WIN32
 } // namespace dxc
 
@@ -0,0 +1,486 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// dxcserver.cpp                                                             //
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+// This file is distributed under the University of Illinois Open Source     //
+// License. See LICENSE.TXT for details.                                     //
+//                                                                           //
+// Provides the local compile server of the dxc console program and the     //
+// client that forwards compilations to it.                                  //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WIN32
+
+#include "dxcserver.h"
+#include "dxc.h"
+#include "dxc/Support/Global.h"
+#include "dxc/Support/WinIncludes.h"
+#include "dxc/Support/dxcapi.use.h"
+#include "dxc/dxcapi.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+// The protocol is local-only; client and server share the file system.
+//
+// Request:  magic, version and argument count as 32-bit integers, sent along
+//           with the client's stdin, stdout and stderr descriptors, followed
+//           by the working directory and each argument, each as a 32-bit
+//           length and its bytes.
+// Response: the exit code of the compilation as a 32-bit integer.
+const uint32_t kServerMagic = 0x53435844; // 'DXCS'
+const uint32_t kServerVersion = 1;
+const uint32_t kMaxArgCount = 1 << 16;
+const uint32_t kMaxStringLength = 1 << 20;
+const unsigned kStdStreamCount = 3;
+
+const char kConnectOption[] = "--connect";
+const char kServerOption[] = "--server";
+
+// Writing to a socket the peer has closed must fail with EPIPE rather than
+// raise SIGPIPE, which would kill the client before it reports the error.
+#ifdef MSG_NOSIGNAL
+const int kSendFlags = MSG_NOSIGNAL;
+#else
+const int kSendFlags = 0;
+#endif
+
+volatile sig_atomic_t g_StopServer = 0;
+int g_SignalPipe[2] = {-1, -1};
+
+void OnServerSignal(int signal) {
+  int savedErrno = errno;
+  if (signal != SIGCHLD)
+    g_StopServer = 1;
+  char c = 0;
+  (void)write(g_SignalPipe[1], &c, 1);
+  errno = savedErrno;
+}
+
+bool WriteAll(int fd, const void *pData, size_t size) {
+  const char *pBytes = static_cast<const char *>(pData);
+  while (size) {
+    ssize_t written = send(fd, pBytes, size, kSendFlags);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    pBytes += written;
+    size -= written;
+  }
+  return true;
+}
+
+bool ReadAll(int fd, void *pData, size_t size) {
+  char *pBytes = static_cast<char *>(pData);
+  while (size) {
+    ssize_t read = ::read(fd, pBytes, size);
+    if (read < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    if (read == 0)
+      return false;
+    pBytes += read;
+    size -= read;
+  }
+  return true;
+}
+
+bool WriteString(int fd, const std::string &str) {
+  uint32_t length = static_cast<uint32_t>(str.size());
+  return WriteAll(fd, &length, sizeof(length)) &&
+         WriteAll(fd, str.data(), length);
+}
+
+bool ReadString(int fd, std::string &str) {
+  uint32_t length;
+  if (!ReadAll(fd, &length, sizeof(length)) || length > kMaxStringLength)
+    return false;
+  str.resize(length);
+  return length == 0 || ReadAll(fd, &str[0], length);
+}
+
+bool SetSocketAddress(const char *pSocketPath, sockaddr_un &addr) {
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(pSocketPath) >= sizeof(addr.sun_path)) {
+    fprintf(stderr, "dxc failed : socket path is too long: %s\n", pSocketPath);
+    return false;
+  }
+  strcpy(addr.sun_path, pSocketPath);
+  return true;
+}
+
+bool SendRequestHeader(int fd, const uint32_t (&header)[3]) {
+  int fds[kStdStreamCount] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+  union {
+    cmsghdr align;
+    char buffer[CMSG_SPACE(sizeof(fds))];
+  } control;
+  memset(&control, 0, sizeof(control));
+
+  iovec iov = {const_cast<uint32_t *>(header), sizeof(header)};
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buffer;
+  msg.msg_controllen = sizeof(control.buffer);
+  cmsghdr *pControl = CMSG_FIRSTHDR(&msg);
+  pControl->cmsg_level = SOL_SOCKET;
+  pControl->cmsg_type = SCM_RIGHTS;
+  pControl->cmsg_len = CMSG_LEN(sizeof(fds));
+  memcpy(CMSG_DATA(pControl), fds, sizeof(fds));
+
+  ssize_t sent;
+  do {
+    sent = sendmsg(fd, &msg, kSendFlags);
+  } while (sent < 0 && errno == EINTR);
+  return sent == static_cast<ssize_t>(sizeof(header));
+}
+
+bool ReceiveRequestHeader(int fd, uint32_t (&header)[3],
+                          int (&fds)[kStdStreamCount]) {
+  union {
+    cmsghdr align;
+    char buffer[CMSG_SPACE(sizeof(fds))];
+  } control;
+  memset(&control, 0, sizeof(control));
+
+  iovec iov = {header, sizeof(header)};
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buffer;
+  msg.msg_controllen = sizeof(control.buffer);
+
+  ssize_t received;
+  do {
+    received = recvmsg(fd, &msg, 0);
+  } while (received < 0 && errno == EINTR);
+
+  cmsghdr *pControl = CMSG_FIRSTHDR(&msg);
+  if (received != static_cast<ssize_t>(sizeof(header)) || !pControl ||
+      pControl->cmsg_level != SOL_SOCKET ||
+      pControl->cmsg_type != SCM_RIGHTS ||
+      pControl->cmsg_len != CMSG_LEN(sizeof(fds)))
+    return false;
+  memcpy(fds, CMSG_DATA(pControl), sizeof(fds));
+  return true;
+}
+
+// Only accepts compilations from the user running the server.
+bool IsSameUser(int fd) {
+#ifdef SO_PEERCRED
+  ucred credentials;
+  socklen_t length = sizeof(credentials);
+  return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0 &&
+         credentials.uid == geteuid();
+#else
+  uid_t uid;
+  gid_t gid;
+  return getpeereid(fd, &uid, &gid) == 0 && uid == geteuid();
+#endif
+}
+
+// Runs in the forked process: reads the request from the client, takes over
+// its standard streams and working directory, and runs the compilation.
+int ServeRequest(int clientFd) {
+  uint32_t header[3];
+  int fds[kStdStreamCount];
+  if (!ReceiveRequestHeader(clientFd, header, fds))
+    return 1;
+  if (header[0] != kServerMagic || header[1] != kServerVersion ||
+      header[2] == 0 || header[2] > kMaxArgCount)
+    return 1;
+
+  std::string workingDirectory;
+  std::vector<std::string> args(header[2]);
+  if (!ReadString(clientFd, workingDirectory))
+    return 1;
+  for (std::string &arg : args) {
+    if (!ReadString(clientFd, arg))
+      return 1;
+  }
+  close(clientFd);
+
+  for (unsigned i = 0; i < kStdStreamCount; ++i) {
+    if (dup2(fds[i], static_cast<int>(i)) < 0)
+      return 1;
+  }
+  for (int fd : fds) {
+    if (fd >= static_cast<int>(kStdStreamCount))
+      close(fd);
+  }
+
+  if (chdir(workingDirectory.c_str()) != 0) {
+    fprintf(stderr, "dxc failed : cannot change to directory %s: %s\n",
+            workingDirectory.c_str(), strerror(errno));
+    return 1;
+  }
+
+  std::vector<const char *> argv;
+  for (const std::string &arg : args) {
+    if (arg == kServerOption || arg == kConnectOption) {
+      fprintf(stderr, "dxc failed : %s cannot be forwarded to a compile "
+                      "server.\n",
+              arg.c_str());
+      return 1;
+    }
+    argv.push_back(arg.c_str());
+  }
+
+  int result =
+      dxc::RunForwardedCompilation(static_cast<int>(argv.size()), argv.data());
+  fflush(stdout);
+  fflush(stderr);
+  return result;
+}
+
+// Binds the server socket, replacing a stale socket left by a previous server
+// that is no longer running. Never removes anything but a socket.
+int BindServerSocket(const sockaddr_un &addr) {
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+
+  // Only the current user may connect to the socket.
+  mode_t previousMask = umask(0077);
+  int result = bind(fd, reinterpret_cast<const sockaddr *>(&addr),
+                    sizeof(addr));
+  struct stat st;
+  if (result != 0 && errno == EADDRINUSE &&
+      lstat(addr.sun_path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+    int probeFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probeFd >= 0 &&
+        connect(probeFd, reinterpret_cast<const sockaddr *>(&addr),
+                sizeof(addr)) != 0 &&
+        errno == ECONNREFUSED) {
+      unlink(addr.sun_path);
+      result = bind(fd, reinterpret_cast<const sockaddr *>(&addr),
+                    sizeof(addr));
+    }
+    if (probeFd >= 0)
+      close(probeFd);
+  }
+  umask(previousMask);
+
+  if (result != 0 || listen(fd, SOMAXCONN) != 0) {
+    int savedErrno = errno;
+    close(fd);
+    errno = savedErrno;
+    return -1;
+  }
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+  return fd;
+}
+
+int32_t GetExitCode(int status) {
+  if (WIFEXITED(status))
+    return WEXITSTATUS(status);
+  if (WIFSIGNALED(status))
+    return 128 + WTERMSIG(status);
+  return 1;
+}
+
+} // namespace
+
+bool dxc::RunCompileClient(int argc, const char **argv, int *pExitCode) {
+  const char *pSocketPath = nullptr;
+  std::vector<std::string> args;
+  for (int i = 0; i < argc; ++i) {
+    if (i > 0 && !pSocketPath && i + 1 < argc &&
+        strcmp(argv[i], kConnectOption) == 0) {
+      pSocketPath = argv[++i];
+      continue;
+    }
+    args.push_back(argv[i]);
+  }
+  if (!pSocketPath)
+    return false;
+
+  *pExitCode = 1;
+  sockaddr_un addr;
+  if (!SetSocketAddress(pSocketPath, addr))
+    return true;
+
+  char workingDirectory[PATH_MAX];
+  if (!getcwd(workingDirectory, sizeof(workingDirectory))) {
+    fprintf(stderr, "dxc failed : cannot get the working directory: %s\n",
+            strerror(errno));
+    return true;
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr *>(&addr),
+                        sizeof(addr)) != 0) {
+    fprintf(stderr, "dxc failed : cannot connect to compile server at %s: %s\n",
+            pSocketPath, strerror(errno));
+    if (fd >= 0)
+      close(fd);
+    return true;
+  }
+#ifdef SO_NOSIGPIPE
+  int noSigPipe = 1;
+  setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+  uint32_t header[3] = {kServerMagic, kServerVersion,
+                        static_cast<uint32_t>(args.size())};
+  bool connected = SendRequestHeader(fd, header) &&
+                   WriteString(fd, workingDirectory);
+  for (const std::string &arg : args)
+    connected = connected && WriteString(fd, arg);
+
+  int32_t exitCode;
+  if (connected && ReadAll(fd, &exitCode, sizeof(exitCode)))
+    *pExitCode = exitCode;
+  else
+    fprintf(stderr, "dxc failed : lost connection to compile server at %s\n",
+            pSocketPath);
+  close(fd);
+  return true;
+}
+
+int dxc::RunCompileServer(const char *pSocketPath,
+                          dxc::DxcDllSupport &dxcSupport) {
+  sockaddr_un addr;
+  if (!SetSocketAddress(pSocketPath, addr))
+    return 1;
+
+  int listenFd = BindServerSocket(addr);
+  if (listenFd < 0) {
+    fprintf(stderr, "dxc failed : cannot listen on %s: %s\n", pSocketPath,
+            strerror(errno));
+    return 1;
+  }
+
+  // Signals are turned into bytes on a pipe so that the poll loop below can
+  // wait for new clients and finished compilations at the same time.
+  if (pipe(g_SignalPipe) != 0) {
+    fprintf(stderr, "dxc failed : cannot create pipe: %s\n", strerror(errno));
+    close(listenFd);
+    unlink(pSocketPath);
+    return 1;
+  }
+  for (int fd : g_SignalPipe) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+  struct sigaction action = {};
+  action.sa_handler = OnServerSignal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGCHLD, &action, nullptr);
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+  signal(SIGPIPE, SIG_IGN);
+
+  // dxcSupport keeps the compiler library loaded, so forked compilations
+  // inherit it already mapped and statically initialized; loading it again
+  // only takes a reference. They also reuse this process's option table.
+  DXASSERT(dxcSupport.IsEnabled(), "else the compiler was not loaded");
+
+  const unsigned maxJobs = std::max(1u, std::thread::hardware_concurrency());
+  // Client connection of each running compilation, by process id.
+  std::unordered_map<pid_t, int> jobs;
+  auto reapJobs = [&jobs](int options) {
+    int status;
+    pid_t pid;
+    while ((pid = waitpid(-1, &status, options)) > 0) {
+      auto it = jobs.find(pid);
+      if (it == jobs.end())
+        continue;
+      int32_t exitCode = GetExitCode(status);
+      WriteAll(it->second, &exitCode, sizeof(exitCode));
+      close(it->second);
+      jobs.erase(it);
+    }
+  };
+
+  while (!g_StopServer) {
+    // When all workers are busy, only wait for one of them to finish.
+    pollfd pollFds[2] = {{g_SignalPipe[0], POLLIN, 0}, {listenFd, POLLIN, 0}};
+    nfds_t pollCount = jobs.size() < maxJobs ? 2 : 1;
+    if (poll(pollFds, pollCount, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      fprintf(stderr, "dxc failed : poll failed: %s\n", strerror(errno));
+      break;
+    }
+
+    if (pollFds[0].revents & POLLIN) {
+      char buffer[64];
+      while (read(g_SignalPipe[0], buffer, sizeof(buffer)) > 0)
+        ;
+      reapJobs(WNOHANG);
+    }
+
+    if (pollCount < 2 || !(pollFds[1].revents & POLLIN))
+      continue;
+    int clientFd = accept(listenFd, nullptr, nullptr);
+    if (clientFd < 0)
+      continue;
+    if (!IsSameUser(clientFd)) {
+      close(clientFd);
+      continue;
+    }
+
+    fflush(nullptr);
+    pid_t pid = fork();
+    if (pid == 0) {
+      close(listenFd);
+      close(g_SignalPipe[0]);
+      close(g_SignalPipe[1]);
+      for (auto &job : jobs)
+        close(job.second);
+      signal(SIGCHLD, SIG_DFL);
+      signal(SIGINT, SIG_DFL);
+      signal(SIGTERM, SIG_DFL);
+      signal(SIGPIPE, SIG_DFL);
+      _exit(ServeRequest(clientFd));
+    }
+    if (pid < 0) {
+      int32_t exitCode = 1;
+      WriteAll(clientFd, &exitCode, sizeof(exitCode));
+      close(clientFd);
+      continue;
+    }
+    jobs[pid] = clientFd;
+  }
+
+  close(listenFd);
+  unlink(pSocketPath);
+  // Let running compilations finish and report back to their clients.
+  while (!jobs.empty()) {
+    size_t previousCount = jobs.size();
+    reapJobs(0);
+    if (jobs.size() == previousCount)
+      break;
+  }
+  return 0;
+}
+
+#endif // _WIN32
@@ -0,0 +1,38 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// dxcserver.h                                                               //
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+// This file is distributed under the University of Illinois Open Source     //
+// License. See LICENSE.TXT for details.                                     //
+//                                                                           //
+// Provides the local compile server of the dxc console program and the     //
+// client that forwards compilations to it.                                  //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#ifndef __DXC_DXCSERVER__
+#define __DXC_DXCSERVER__
+
+#ifndef _WIN32
+
+namespace dxc {
+class DxcDllSupport;
+
+// If the arguments contain --connect <socket>, forwards the remaining
+// arguments, the working directory and the standard streams to the compile
+// server listening on <socket>, stores the exit code of the compilation in
+// pExitCode and returns true. Returns false otherwise. Doesn't load the
+// compiler or the option table.
+bool RunCompileClient(int argc, const char **argv, int *pExitCode);
+
+// Listens on the given Unix domain socket and runs each compilation forwarded
+// by a client in a process forked from this one. dxcSupport must have loaded
+// the compiler, so that each compilation inherits the loaded and statically
+// initialized library instead of loading it. Runs until interrupted.
+int RunCompileServer(const char *pSocketPath, DxcDllSupport &dxcSupport);
+} // namespace dxc
+
+#endif // _WIN32
+
+#endif // __DXC_DXCSERVER__
@@ -24,6 +24,7 @@
 #include "dxc/DXIL/DxilShaderModel.h"
 #include "dxc/DXIL/DxilUtil.h"
 #include "dxc/DxilContainer/DxilContainer.h"
+#include "dxc/DxilContainer/DxilContainerReader.h"
 #include "dxc/DxilContainer/DxilPipelineStateValidation.h"
 #include "dxc/DxilContainer/DxilRuntimeReflection.h"
 #include "dxc/HLSL/ComputeViewIdState.h"
@@ -1653,109 +1654,95 @@ HRESULT Disassemble(IDxcBlob *pProgram, raw_string_ostream &Stream) {
       return DXC_E_CONTAINER_INVALID;
     }
 
-    DxilPartIterator it = std::find_if(begin(pContainer), end(pContainer),
-                                       DxilPartIsType(DFCC_FeatureInfo));
-    if (it != end(pContainer)) {
-      PrintFeatureInfo(
-          reinterpret_cast<const DxilShaderFeatureInfo *>(GetDxilPartData(*it)),
-          Stream, /*comment*/ ";");
+    DxilPartIndex PartIndex(pContainer);
+    const DxilPartHeader *pPart = PartIndex.GetPartByType(DFCC_FeatureInfo);
+    if (pPart) {
+      PrintFeatureInfo(reinterpret_cast<const DxilShaderFeatureInfo *>(
+                           GetDxilPartData(pPart)),
+                       Stream, /*comment*/ ";");
     }
 
-    it = std::find_if(begin(pContainer), end(pContainer),
-                      DxilPartIsType(DFCC_InputSignature));
-    if (it != end(pContainer)) {
-      PrintSignature(
-          "Input",
-          reinterpret_cast<const DxilProgramSignature *>(GetDxilPartData(*it)),
-          true, Stream, /*comment*/ ";");
+    pPart = PartIndex.GetPartByType(DFCC_InputSignature);
+    if (pPart) {
+      PrintSignature("Input",
+                     reinterpret_cast<const DxilProgramSignature *>(
+                         GetDxilPartData(pPart)),
+                     true, Stream, /*comment*/ ";");
     }
-    it = std::find_if(begin(pContainer), end(pContainer),
-                      DxilPartIsType(DFCC_OutputSignature));
-    if (it != end(pContainer)) {
-      PrintSignature(
-          "Output",
-          reinterpret_cast<const DxilProgramSignature *>(GetDxilPartData(*it)),
-          false, Stream, /*comment*/ ";");
+    pPart = PartIndex.GetPartByType(DFCC_OutputSignature);
+    if (pPart) {
+      PrintSignature("Output",
+                     reinterpret_cast<const DxilProgramSignature *>(
+                         GetDxilPartData(pPart)),
+                     false, Stream, /*comment*/ ";");
     }
-    it = std::find_if(begin(pContainer), end(pContainer),
-                      DxilPartIsType(DFCC_PatchConstantSignature));
-    if (it != end(pContainer)) {
-      PrintSignature(
-          "Patch Constant signature",
-          reinterpret_cast<const DxilProgramSignature *>(GetDxilPartData(*it)),
-          false, Stream, /*comment*/ ";");
+    pPart = PartIndex.GetPartByType(DFCC_PatchConstantSignature);
+    if (pPart) {
+      PrintSignature("Patch Constant signature",
+                     reinterpret_cast<const DxilProgramSignature *>(
+                         GetDxilPartData(pPart)),
+                     false, Stream, /*comment*/ ";");
     }
 
-    it = std::find_if(begin(pContainer), end(pContainer),
-                      DxilPartIsType(DFCC_ShaderDebugName));
-    if (it != end(pContainer)) {
+    pPart = PartIndex.GetPartByType(DFCC_ShaderDebugName);
+    if (pPart) {
       const char *pDebugName;
-      if (!GetDxilShaderDebugName(*it, &pDebugName, nullptr)) {
+      if (!GetDxilShaderDebugName(pPart, &pDebugName, nullptr)) {
         Stream << "; shader debug name present; corruption detected\n";
       } else if (pDebugName && *pDebugName) {
         Stream << "; shader debug name: " << pDebugName << "\n";
       }
     }
 
-    it = std::find_if(begin(pContainer), end(pContainer),
-                      DxilPartIsType(DFCC_ShaderHash));
-    if (it != end(pContainer)) {
+    pPart = PartIndex.GetPartByType(DFCC_ShaderHash);
+    if (pPart) {
       const DxilShaderHash *pHashContent =
-          reinterpret_cast<const DxilShaderHash *>(GetDxilPartData(*it));
+          reinterpret_cast<const DxilShaderHash *>(GetDxilPartData(pPart));
       Stream << "; shader hash: ";
       for (int i = 0; i < 16; ++i)
         Stream << format("%.2x", pHashContent->Digest[i]);
       if (pHashContent->Flags & (uint32_t)DxilShaderHashFlags::IncludesSource)
         Stream << " (includes source)";
+      if (pHashContent->Flags & (uint32_t)DxilShaderHashFlags::XXHash64)
+        Stream << " (xxhash64)";
       Stream << "\n";
     }
 
-    it = std::find_if(begin(pContainer), end(pContainer),
-                      DxilPartIsType(DFCC_DXIL));
-
-    DxilPartIterator dbgit =
-        std::find_if(begin(pContainer), end(pContainer),
-                     DxilPartIsType(DFCC_ShaderDebugInfoDXIL));
     // Use dbg module if exist.
-    if (dbgit != end(pContainer))
-      it = dbgit;
+    pPart = PartIndex.GetPartByType(DFCC_ShaderDebugInfoDXIL);
+    if (!pPart)
+      pPart = PartIndex.GetPartByType(DFCC_DXIL);
 
-    if (it == end(pContainer)) {
+    if (!pPart) {
       return DXC_E_CONTAINER_MISSING_DXIL;
     }
 
     const DxilProgramHeader *pProgramHeader =
-        reinterpret_cast<const DxilProgramHeader *>(GetDxilPartData(*it));
-    if (!IsValidDxilProgramHeader(pProgramHeader, (*it)->PartSize)) {
+        reinterpret_cast<const DxilProgramHeader *>(GetDxilPartData(pPart));
+    if (!IsValidDxilProgramHeader(pProgramHeader, pPart->PartSize)) {
       return DXC_E_CONTAINER_INVALID;
     }
 
-    it = std::find_if(begin(pContainer), end(pContainer),
-                      DxilPartIsType(DFCC_PipelineStateValidation));
-    if (it != end(pContainer)) {
+    pPart = PartIndex.GetPartByType(DFCC_PipelineStateValidation);
+    if (pPart) {
       PrintPipelineStateValidationRuntimeInfo(
-          GetDxilPartData(*it), (*it)->PartSize,
+          GetDxilPartData(pPart), pPart->PartSize,
           GetVersionShaderType(pProgramHeader->ProgramVersion), Stream,
           /*comment*/ ";");
     }
 
     // RDAT
-    it = std::find_if(begin(pContainer), end(pContainer),
-                      DxilPartIsType(DFCC_RuntimeData));
-    if (it != end(pContainer)) {
-      pRDATPart = *it;
-    }
+    pRDATPart = PartIndex.GetPartByType(DFCC_RuntimeData);
 
     GetDxilProgramBitcode(pProgramHeader, &pIL, &pILLength);
 
-    it = std::find_if(begin(pContainer), end(pContainer),
-                      DxilPartIsType(DFCC_ShaderStatistics));
-    if (it != end(pContainer)) {
+    pPart = PartIndex.GetPartByType(DFCC_ShaderStatistics);
+    if (pPart) {
       // If this part exists, use it for reflection data, probably stripped from
       // DXIL part.
       const DxilProgramHeader *pReflectionProgramHeader =
-          reinterpret_cast<const DxilProgramHeader *>(GetDxilPartData(*it));
-      if (IsValidDxilProgramHeader(pReflectionProgramHeader, (*it)->PartSize)) {
+          reinterpret_cast<const DxilProgramHeader *>(GetDxilPartData(pPart));
+      if (IsValidDxilProgramHeader(pReflectionProgramHeader, pPart->PartSize)) {
         GetDxilProgramBitcode(pReflectionProgramHeader, &pReflectionIL,
                               &pReflectionILLength);
       }
@@ -19,9 +19,14 @@
 
 #include "dxc/DXIL/DxilPDB.h"
 #include "dxc/DxilContainer/DxilContainer.h"
+#include "dxc/DxilContainer/DxilReflectionDatabase.h"
 #include "dxc/dxcapi.internal.h"
 #include "dxc/dxctools.h"
 
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -226,7 +231,7 @@ public:
   GetBlobAsWide(IDxcBlob *pBlob, IDxcBlobEncoding **pBlobEncoding) override;
 };
 
-class DxcUtils : public IDxcUtils {
+class DxcUtils : public IDxcUtils2 {
   friend class DxcLibrary;
 
 private:
@@ -241,7 +246,8 @@ public:
 
   HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid,
                                            void **ppvObject) override {
-    HRESULT hr = DoBasicQueryInterface<IDxcUtils>(this, iid, ppvObject);
+    HRESULT hr =
+        DoBasicQueryInterface<IDxcUtils2, IDxcUtils>(this, iid, ppvObject);
     if (FAILED(hr)) {
       return DoBasicQueryInterface<IDxcLibrary>(&m_Library, iid, ppvObject);
     }
@@ -298,6 +304,18 @@ public:
     return ::hlsl::DxcCreateBlobFromFile(pFileName, pCodePage, pBlobEncoding);
   }
 
+  virtual HRESULT STDMETHODCALLTYPE
+  LoadFileWithFlags(LPCWSTR pFileName, UINT32 *pCodePage, UINT32 flags,
+                    IDxcBlobEncoding **pBlobEncoding) override {
+    if (flags & ~DxcLoadFileFlags_Map)
+      return E_INVALIDARG;
+    if (!(flags & DxcLoadFileFlags_Map) || pCodePage != nullptr)
+      return LoadFile(pFileName, pCodePage, pBlobEncoding);
+    DxcThreadMalloc TM(m_pMalloc);
+    return ::hlsl::DxcCreateBlobFromFileMapped(DxcGetThreadMallocNoRef(),
+                                               pFileName, pBlobEncoding);
+  }
+
   HRESULT STDMETHODCALLTYPE
   CreateReadOnlyStreamFromBlob(IDxcBlob *pBlob, IStream **ppStream) override {
     DxcThreadMalloc TM(m_pMalloc);
@@ -462,6 +480,56 @@ public:
     CATCH_CPP_RETURN_HRESULT();
   }
 
+  virtual HRESULT STDMETHODCALLTYPE
+  CreateReflectionDatabase(const DxcBuffer *pContainers, UINT32 containerCount,
+                           IDxcBlob **ppDatabase) override {
+    if ((!pContainers && containerCount) || !ppDatabase)
+      return E_INVALIDARG;
+    *ppDatabase = nullptr;
+
+    DxcThreadMalloc TM(m_pMalloc);
+    try {
+      std::vector<hlsl::DxilReflectionDatabaseEntry> entries(containerCount);
+
+      std::atomic<UINT32> nextContainer(0);
+      auto reflectWorker = [&]() {
+        DxcThreadMalloc TM(m_pMalloc);
+        for (UINT32 i = nextContainer++; i < containerCount;
+             i = nextContainer++) {
+          const DxcBuffer &container = pContainers[i];
+          HRESULT hr = E_INVALIDARG;
+          if (container.Ptr && container.Encoding == DXC_CP_ACP)
+            hr = hlsl::CreateDxilReflectionDatabaseEntry(
+                container.Ptr, container.Size, entries[i]);
+          if (FAILED(hr))
+            entries[i] = hlsl::DxilReflectionDatabaseEntry();
+          entries[i].Shader.Result = (uint32_t)hr;
+        }
+      };
+
+      // This thread reflects containers, too.
+      unsigned threadCount = std::min<unsigned>(
+          std::max(1u, std::thread::hardware_concurrency()), containerCount);
+      std::vector<std::thread> workers;
+      for (unsigned t = 1; t < threadCount; ++t) {
+        try {
+          workers.emplace_back(reflectWorker);
+        } catch (const std::system_error &) {
+          break;
+        }
+      }
+      reflectWorker();
+      for (std::thread &worker : workers)
+        worker.join();
+
+      std::vector<char> database;
+      hlsl::WriteDxilReflectionDatabase(entries, database);
+      return hlsl::DxcCreateBlobOnHeapCopy(database.data(),
+                                           (UINT32)database.size(), ppDatabase);
+    }
+    CATCH_CPP_RETURN_HRESULT();
+  }
+
   virtual HRESULT STDMETHODCALLTYPE BuildArguments(
       LPCWSTR pSourceName, // Optional file name for pSource. Used in errors and
                            // include handlers.
@@ -25,6 +25,8 @@
 #include "clang/Sema/SemaHLSL.h"
 #include "llvm/Bitcode/ReaderWriter.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Transforms/Utils/Cloning.h"
@@ -58,11 +60,18 @@
 #include "dxcversion.inc"
 #include "dxillib.h"
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
 
 // SPIRV change starts
 #ifdef ENABLE_SPIRV_CODEGEN
 #include "clang/SPIRV/EmitSpirvAction.h"
+#include "clang/SPIRV/OptimizerCache.h"
+#include "clang/SPIRV/ReflectionBlob.h"
 #endif
 // SPIRV change ends
 
@@ -224,6 +233,77 @@ static HRESULT CreateContainerForPDB(IMalloc *pMalloc, IDxcBlob *pOldContainer,
   return S_OK;
 }
 
+static HRESULT Utf8ToBlobWide(IMalloc *pMalloc, llvm::StringRef str,
+                              IDxcBlobWide **ppResult) {
+  CComPtr<IDxcBlobEncoding> pUtf8Blob;
+  IFR(hlsl::DxcCreateBlob(str.data(), str.size(),
+                          /*bPinned*/ true, /*bCopy*/ false,
+                          /*encodingKnown*/ true, CP_UTF8, pMalloc,
+                          &pUtf8Blob));
+  return hlsl::DxcGetBlobAsWide(pUtf8Blob, pMalloc, ppResult);
+}
+
+// Returns the sources referenced from the PDB by -Qsource_store as extra
+// outputs named <store>/<key>, for the host to write into the store.
+static HRESULT CreateSourceStoreOutputs(
+    IMalloc *pMalloc, llvm::StringRef storeDir,
+    llvm::ArrayRef<hlsl::SourceInfoWriter::StoredSource> storedSources,
+    IDxcExtraOutputs **ppOutputs) {
+  std::vector<DxcExtraOutputObject> objects;
+  for (const hlsl::SourceInfoWriter::StoredSource &source : storedSources) {
+    DxcExtraOutputObject object;
+    CComPtr<IDxcBlob> pContent;
+    IFR(hlsl::DxcCreateBlobOnHeapCopy(source.Content.data(),
+                                      source.Content.size(), &pContent));
+    object.pObject = pContent;
+
+    llvm::SmallString<256> path(storeDir);
+    llvm::sys::path::append(path, source.Key);
+    IFR(Utf8ToBlobWide(pMalloc, path, &object.pName));
+    IFR(Utf8ToBlobWide(pMalloc, "source", &object.pType));
+    objects.push_back(object);
+  }
+
+  CComPtr<DxcExtraOutputs> pOutputs = DxcExtraOutputs::Alloc(pMalloc);
+  if (!pOutputs)
+    return E_OUTOFMEMORY;
+  pOutputs->SetOutputs(objects);
+  return pOutputs.QueryInterface(ppOutputs);
+}
+
+#ifdef ENABLE_SPIRV_CODEGEN
+// Returns the module of each entry point given with -fspv-entry-points as an
+// extra output named <entry point>.spv, next to the -Fo output.
+static HRESULT CreateSpirvEntryPointOutputs(
+    IMalloc *pMalloc, llvm::StringRef outputObject,
+    llvm::ArrayRef<llvm::StringRef> entryPoints,
+    llvm::ArrayRef<std::vector<uint32_t>> modules,
+    IDxcExtraOutputs **ppOutputs) {
+  DXASSERT_NOMSG(entryPoints.size() == modules.size());
+  std::vector<DxcExtraOutputObject> objects;
+  for (size_t i = 0; i < modules.size(); ++i) {
+    DxcExtraOutputObject object;
+    CComPtr<IDxcBlob> pModule;
+    IFR(hlsl::DxcCreateBlobOnHeapCopy(
+        modules[i].data(), (UINT32)(modules[i].size() * sizeof(uint32_t)),
+        &pModule));
+    object.pObject = pModule;
+
+    llvm::SmallString<256> path(llvm::sys::path::parent_path(outputObject));
+    llvm::sys::path::append(path, entryPoints[i] + ".spv");
+    IFR(Utf8ToBlobWide(pMalloc, path, &object.pName));
+    IFR(Utf8ToBlobWide(pMalloc, "spirv", &object.pType));
+    objects.push_back(object);
+  }
+
+  CComPtr<DxcExtraOutputs> pOutputs = DxcExtraOutputs::Alloc(pMalloc);
+  if (!pOutputs)
+    return E_OUTOFMEMORY;
+  pOutputs->SetOutputs(objects);
+  return pOutputs.QueryInterface(ppOutputs);
+}
+#endif // ENABLE_SPIRV_CODEGEN
+
 #ifdef _WIN32
 
 #pragma fenv_access(on)
@@ -462,7 +542,75 @@ static HRESULT ErrorWithString(const std::string &error, REFIID riid,
   return S_OK;
 }
 
-class DxcCompiler : public IDxcCompiler3,
+HRESULT CreateDxcUtils(REFIID riid, LPVOID *ppv);
+
+// Include handler shared by all permutations compiled by
+// IDxcCompiler4::CompilePermutations. Each file is loaded through the user's
+// include handler, and converted to UTF-8 if its encoding is known, only once.
+// The user's include handler is never called concurrently.
+class DxcSharedIncludeHandler : public IDxcIncludeHandler {
+private:
+  DXC_MICROCOM_TM_REF_FIELDS()
+  CComPtr<IDxcIncludeHandler> m_pIncludeHandler;
+  std::mutex m_Mutex;
+  // Result of the user's include handler for each file, including failures.
+  std::unordered_map<std::wstring, std::pair<HRESULT, CComPtr<IDxcBlob>>>
+      m_Sources;
+
+public:
+  DXC_MICROCOM_TM_ADDREF_RELEASE_IMPL()
+  DXC_MICROCOM_TM_ALLOC(DxcSharedIncludeHandler)
+  DxcSharedIncludeHandler(IMalloc *pMalloc,
+                          IDxcIncludeHandler *pIncludeHandler)
+      : m_dwRef(0), m_pMalloc(pMalloc), m_pIncludeHandler(pIncludeHandler) {}
+
+  HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid,
+                                           void **ppvObject) override {
+    return DoBasicQueryInterface<IDxcIncludeHandler>(this, iid, ppvObject);
+  }
+
+  HRESULT STDMETHODCALLTYPE LoadSource(
+      LPCWSTR pFilename,         // Candidate filename.
+      IDxcBlob **ppIncludeSource // Resultant source object for included file,
+                                 // nullptr if not found.
+      ) override {
+    if (pFilename == nullptr || ppIncludeSource == nullptr)
+      return E_INVALIDARG;
+    *ppIncludeSource = nullptr;
+    try {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      auto it = m_Sources.find(pFilename);
+      if (it == m_Sources.end()) {
+        CComPtr<IDxcBlob> pSource;
+        HRESULT hr = m_pIncludeHandler->LoadSource(pFilename, &pSource);
+        // Sources of unknown encoding are left for each compilation to
+        // convert with its default code page.
+        CComPtr<IDxcBlobEncoding> pSourceEncoding;
+        BOOL encodingKnown = FALSE;
+        UINT32 codePage = 0;
+        if (SUCCEEDED(hr) && pSource &&
+            SUCCEEDED(pSource.QueryInterface(&pSourceEncoding)) &&
+            SUCCEEDED(pSourceEncoding->GetEncoding(&encodingKnown,
+                                                   &codePage)) &&
+            encodingKnown) {
+          CComPtr<IDxcBlobUtf8> pUtf8Source;
+          IFT(hlsl::DxcGetBlobAsUtf8(pSource, m_pMalloc, &pUtf8Source));
+          pSource = pUtf8Source.p;
+        }
+        it = m_Sources
+                 .insert(std::make_pair(std::wstring(pFilename),
+                                        std::make_pair(hr, pSource)))
+                 .first;
+      }
+      if (it->second.second)
+        IFT(it->second.second.CopyTo(ppIncludeSource));
+      return it->second.first;
+    }
+    CATCH_CPP_RETURN_HRESULT();
+  }
+};
+
+class DxcCompiler : public IDxcCompiler4,
                     public IDxcLangExtensions3,
                     public IDxcContainerEvent,
                     public IDxcVersionInfo3,
@@ -477,6 +625,11 @@ private:
   DxcLangExtensionsHelper m_langExtensionsHelper;
   CComPtr<IDxcContainerEventsHandler> m_pDxcContainerEventsHandler;
   DxcCompilerAdapter m_DxcCompilerAdapter;
+#ifdef ENABLE_SPIRV_CODEGEN
+  // SPIR-V optimizers reused by all compilations on this object.
+  std::shared_ptr<clang::spirv::OptimizerCache> m_pSpirvOptimizerCache =
+      std::make_shared<clang::spirv::OptimizerCache>();
+#endif // ENABLE_SPIRV_CODEGEN
 
 public:
   DxcCompiler(IMalloc *pMalloc)
@@ -503,9 +656,10 @@ public:
 
   HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid,
                                            void **ppvObject) override {
-    HRESULT hr = DoBasicQueryInterface<IDxcCompiler3, IDxcLangExtensions,
-                                       IDxcLangExtensions2, IDxcLangExtensions3,
-                                       IDxcContainerEvent, IDxcVersionInfo
+    HRESULT hr = DoBasicQueryInterface<IDxcCompiler4, IDxcCompiler3,
+                                       IDxcLangExtensions, IDxcLangExtensions2,
+                                       IDxcLangExtensions3, IDxcContainerEvent,
+                                       IDxcVersionInfo
 #ifdef SUPPORT_QUERY_GIT_COMMIT_INFO
                                        ,
                                        IDxcVersionInfo2
@@ -953,6 +1107,9 @@ public:
         opts.SpirvOptions.codeGenHighLevel = opts.CodeGenHighLevel;
         opts.SpirvOptions.defaultRowMajor = opts.DefaultRowMajor;
         opts.SpirvOptions.disableValidation = opts.DisableValidation;
+        opts.SpirvOptions.timeReport = opts.TimeReport;
+        opts.SpirvOptions.stripDebugInfo = opts.StripDebug && opts.DebugInfo;
+        opts.SpirvOptions.optimizerCache = m_pSpirvOptimizerCache;
         // Save a string representation of command line options and
         // input file name.
         if (opts.DebugInfo) {
@@ -970,7 +1127,79 @@ public:
         action.BeginSourceFile(compiler, file);
         action.Execute();
         action.EndSourceFile();
+
+        // With -fspv-entry-points, the object is the module of the first
+        // entry point, and all of them are returned as extra outputs.
+        const auto &entryPointModules =
+            compiler.getCodeGenOpts().SpirvOptions.entryPointModules;
+        if (!entryPointModules.empty() &&
+            !compiler.getDiagnostics().hasErrorOccurred()) {
+          const std::vector<uint32_t> &firstModule = entryPointModules.front();
+          outStream.write(reinterpret_cast<const char *>(firstModule.data()),
+                          firstModule.size() * sizeof(uint32_t));
+          CComPtr<IDxcExtraOutputs> pEntryPointOutputs;
+          IFT(CreateSpirvEntryPointOutputs(
+              m_pMalloc, opts.OutputObject, opts.SpirvOptions.entryPoints,
+              entryPointModules, &pEntryPointOutputs));
+          IFT(pResult->SetOutputObject(DXC_OUT_EXTRA_OUTPUTS,
+                                       pEntryPointOutputs));
+        }
         outStream.flush();
+
+        const std::string &optimizerTimeReport =
+            compiler.getCodeGenOpts().SpirvOptions.optimizerTimeReport;
+        if (!optimizerTimeReport.empty())
+          IFT(pResult->SetOutputString(DXC_OUT_TIME_REPORT,
+                                       optimizerTimeReport.c_str(),
+                                       optimizerTimeReport.size()));
+
+        // With -Qstrip_debug the object is the stripped module, and the
+        // debug-rich module it was derived from is returned as the PDB.
+        const std::vector<uint32_t> &debugModule =
+            compiler.getCodeGenOpts().SpirvOptions.debugModule;
+        if (!debugModule.empty() &&
+            !compiler.getDiagnostics().hasErrorOccurred()) {
+          CComPtr<IDxcBlob> pDebugModule;
+          IFT(hlsl::DxcCreateBlobOnHeapCopy(
+              debugModule.data(),
+              (UINT32)(debugModule.size() * sizeof(uint32_t)), &pDebugModule));
+          IFT(pResult->SetOutputObject(DXC_OUT_PDB, pDebugModule));
+          // There is no shader debug name part to take the name from, so
+          // with a directory for -Fd the module is named after the input.
+          std::string debugName = opts.GetPDBName();
+          if (debugName.empty()) {
+            debugName = llvm::sys::path::stem(pUtf8SourceName);
+            debugName += ".pdb";
+          }
+          IFT(pResult->SetOutputName(DXC_OUT_PDB, debugName.c_str()));
+        }
+
+        if (opts.SpirvOptions.emitReflectionBlob &&
+            !compiler.getDiagnostics().hasErrorOccurred()) {
+          llvm::ArrayRef<uint32_t> spirvWords(
+              reinterpret_cast<const uint32_t *>(
+                  pOutputBlob->GetBufferPointer()),
+              pOutputBlob->GetBufferSize() / sizeof(uint32_t));
+          // Resource names are only available in the debug-rich module.
+          if (!debugModule.empty())
+            spirvWords = debugModule;
+          std::vector<uint32_t> reflectionWords;
+          if (clang::spirv::writeReflectionBlob(spirvWords,
+                                                &reflectionWords)) {
+            CComPtr<IDxcBlob> pReflection;
+            IFT(hlsl::DxcCreateBlobOnHeapCopy(
+                reflectionWords.data(),
+                (UINT32)(reflectionWords.size() * sizeof(uint32_t)),
+                &pReflection));
+            IFT(pResult->SetOutputObject(DXC_OUT_REFLECTION, pReflection));
+          } else {
+            auto const ID = compiler.getDiagnostics().getCustomDiagID(
+                clang::DiagnosticsEngine::Warning,
+                "could not create the SPIR-V reflection blob: the generated "
+                "module could not be parsed");
+            compiler.getDiagnostics().Report(ID);
+          }
+        }
       }
 #endif
       // SPIRV change ends
@@ -1155,10 +1384,22 @@ public:
           if (!opts.SourceInDebugModule) { // If we are using old PDB format
                                            // where sources are in debug module,
                                            // do not generate source info at all
+            debugSourceInfoWriter.SetCompression(opts.SourceCompression);
+            debugSourceInfoWriter.SetUseSourceStore(!opts.SourceStore.empty());
             debugSourceInfoWriter.Write(opts.TargetProfile, opts.EntryPoint,
                                         compiler.getCodeGenOpts(),
                                         compiler.getSourceManager());
             pSourceInfo = debugSourceInfoWriter.GetPart();
+
+            if (!opts.SourceStore.empty()) {
+              CComPtr<IDxcExtraOutputs> pSourceStoreOutputs;
+              IFT(CreateSourceStoreOutputs(
+                  m_pMalloc, opts.SourceStore,
+                  debugSourceInfoWriter.m_StoredSources,
+                  &pSourceStoreOutputs));
+              IFT(pResult->SetOutputObject(DXC_OUT_EXTRA_OUTPUTS,
+                                           pSourceStoreOutputs));
+            }
           }
 
           CComPtr<IDxcBlob> pDebugProgramBlob;
@@ -1268,6 +1509,166 @@ public:
     return hr;
   }
 
+  // Compile the same source under several sets of defines, sharing the work
+  // that doesn't depend on the defines.
+  HRESULT STDMETHODCALLTYPE CompilePermutations(
+      const DxcBuffer *pSource,            // Source text to compile
+      LPCWSTR *pArguments,                 // Array of pointers to arguments
+      UINT32 argCount,                     // Number of arguments
+      const DxcDefineSet *pPermutations,   // Defines of each permutation
+      UINT32 permutationCount,             // Number of permutations
+      UINT32 flags,                        // DxcCompilePermutationsFlags_*
+      IDxcIncludeHandler *pIncludeHandler, // user-provided interface to handle
+                                           // #include directives (optional)
+      IDxcResult **ppResults // One result for each permutation
+      ) override {
+    if (pSource == nullptr || ppResults == nullptr ||
+        (argCount > 0 && pArguments == nullptr) ||
+        (permutationCount > 0 && pPermutations == nullptr) ||
+        (flags & ~DxcCompilePermutationsFlags_Deduplicate))
+      return E_INVALIDARG;
+    std::fill(ppResults, ppResults + permutationCount, nullptr);
+
+    DxcThreadMalloc TM(m_pMalloc);
+    try {
+      // Convert the source to UTF-8 once. A source of unknown encoding is left
+      // for each compilation to convert with its default code page.
+      DxcBuffer source = *pSource;
+      CComPtr<IDxcBlobUtf8> pUtf8Source;
+      if (pSource->Encoding != 0) {
+        CComPtr<IDxcBlobEncoding> pSourceEncoding;
+        IFT(hlsl::DxcCreateBlob(pSource->Ptr, pSource->Size, true, false, true,
+                                pSource->Encoding, nullptr, &pSourceEncoding));
+        IFT(hlsl::DxcGetBlobAsUtf8(pSourceEncoding, m_pMalloc, &pUtf8Source));
+        source.Ptr = pUtf8Source->GetStringPointer();
+        source.Size = pUtf8Source->GetStringLength();
+        source.Encoding = CP_UTF8;
+      }
+
+      CComPtr<IDxcIncludeHandler> pSharedIncludeHandler;
+      if (pIncludeHandler) {
+        pSharedIncludeHandler =
+            DxcSharedIncludeHandler::Alloc(m_pMalloc, pIncludeHandler);
+        IFTBOOL(pSharedIncludeHandler, E_OUTOFMEMORY);
+      }
+
+      CComPtr<IDxcUtils> pUtils;
+      IFT(CreateDxcUtils(IID_PPV_ARGS(&pUtils)));
+      std::vector<CComPtr<IDxcCompilerArgs>> permutationArgs(permutationCount);
+      for (UINT32 i = 0; i < permutationCount; ++i) {
+        IFT(pUtils->BuildArguments(nullptr, nullptr, nullptr, pArguments,
+                                   argCount, pPermutations[i].pDefines,
+                                   pPermutations[i].defineCount,
+                                   &permutationArgs[i]));
+      }
+
+      // Permutations whose preprocessed source was already seen reuse the
+      // result of the permutation that first produced it. That is only sound
+      // if the output depends on nothing but the preprocessed source: debug
+      // info records the defines of each permutation, and -rootsig-define
+      // reads a macro that the preprocessed source doesn't show.
+      bool deduplicate = (flags & DxcCompilePermutationsFlags_Deduplicate) != 0;
+      if (deduplicate) {
+        hlsl::options::MainArgs mainArgs(argCount, pArguments, 0);
+        hlsl::options::DxcOpts opts;
+        std::string optionErrors;
+        raw_string_ostream optionErrorsOS(optionErrors);
+        if (hlsl::options::ReadDxcOpts(hlsl::options::getHlslOptTable(),
+                                       hlsl::options::CompilerFlags, mainArgs,
+                                       opts, optionErrorsOS) != 0 ||
+            opts.GeneratePDB() || opts.EmbedDebugInfo() ||
+            opts.SourceInDebugModule || !opts.RootSignatureDefine.empty())
+          deduplicate = false;
+      }
+
+      std::vector<CComPtr<IDxcResult>> results(permutationCount);
+      std::vector<HRESULT> resultHRs(permutationCount, S_OK);
+      std::vector<UINT32> resultIndices(permutationCount);
+      std::iota(resultIndices.begin(), resultIndices.end(), 0);
+      std::unordered_map<std::string, UINT32> preprocessedPermutations;
+      std::mutex preprocessedMutex;
+
+      auto compilePermutation = [&](UINT32 i) -> HRESULT {
+        try {
+          IDxcCompilerArgs *pArgs = permutationArgs[i];
+          if (!deduplicate)
+            return Compile(&source, pArgs->GetArguments(), pArgs->GetCount(),
+                           pSharedIncludeHandler, IID_PPV_ARGS(&results[i]));
+
+          std::vector<LPCWSTR> preprocessArgs(pArgs->GetArguments(),
+                                              pArgs->GetArguments() +
+                                                  pArgs->GetCount());
+          preprocessArgs.push_back(L"-P");
+          preprocessArgs.push_back(L"-Fi");
+          preprocessArgs.push_back(L"permutation.hlsl");
+          CComPtr<IDxcResult> pPreprocessResult;
+          IFR(Compile(&source, preprocessArgs.data(),
+                      (UINT32)preprocessArgs.size(), pSharedIncludeHandler,
+                      IID_PPV_ARGS(&pPreprocessResult)));
+
+          // On preprocessing errors, compile anyway to report them.
+          HRESULT status;
+          CComPtr<IDxcBlob> pPreprocessed;
+          IFR(pPreprocessResult->GetStatus(&status));
+          if (SUCCEEDED(status) &&
+              SUCCEEDED(pPreprocessResult->GetOutput(
+                  DXC_OUT_HLSL, IID_PPV_ARGS(&pPreprocessed), nullptr)) &&
+              pPreprocessed) {
+            llvm::MD5 md5;
+            md5.update(llvm::ArrayRef<uint8_t>(
+                (const uint8_t *)pPreprocessed->GetBufferPointer(),
+                pPreprocessed->GetBufferSize()));
+            llvm::MD5::MD5Result digest;
+            md5.final(digest);
+
+            std::string key((const char *)digest, sizeof(digest));
+            std::lock_guard<std::mutex> lock(preprocessedMutex);
+            auto inserted =
+                preprocessedPermutations.insert(std::make_pair(key, i));
+            if (!inserted.second) {
+              resultIndices[i] = inserted.first->second;
+              return S_OK;
+            }
+          }
+
+          return Compile(&source, pArgs->GetArguments(), pArgs->GetCount(),
+                         pSharedIncludeHandler, IID_PPV_ARGS(&results[i]));
+        }
+        CATCH_CPP_RETURN_HRESULT();
+      };
+
+      std::atomic<UINT32> nextPermutation(0);
+      auto compileWorker = [&]() {
+        DxcThreadMalloc TM(m_pMalloc);
+        for (UINT32 i = nextPermutation++; i < permutationCount;
+             i = nextPermutation++)
+          resultHRs[i] = compilePermutation(i);
+      };
+
+      // This thread takes part in the compilation, too.
+      unsigned threadCount = std::min<unsigned>(
+          std::max(1u, std::thread::hardware_concurrency()), permutationCount);
+      std::vector<std::thread> workers;
+      for (unsigned t = 1; t < threadCount; ++t) {
+        try {
+          workers.emplace_back(compileWorker);
+        } catch (const std::system_error &) {
+          break;
+        }
+      }
+      compileWorker();
+      for (std::thread &worker : workers)
+        worker.join();
+
+      for (UINT32 i = 0; i < permutationCount; ++i)
+        IFR(resultHRs[resultIndices[i]]);
+      for (UINT32 i = 0; i < permutationCount; ++i)
+        IFT(results[resultIndices[i]].CopyTo(&ppResults[i]));
+      return S_OK;
+    }
+    CATCH_CPP_RETURN_HRESULT();
+  }
+
   // Disassemble a program.
   virtual HRESULT STDMETHODCALLTYPE Disassemble(
       const DxcBuffer
@@ -1717,8 +2118,6 @@ HRESULT STDMETHODCALLTYPE DxcCompilerAdapter::Disassemble(
   return hr;
 }
 
-HRESULT CreateDxcUtils(REFIID riid, LPVOID *ppv);
-
 HRESULT STDMETHODCALLTYPE DxcCompilerAdapter::CompileWithDebug(
     IDxcBlob *pSource,   // Source text to compile
     LPCWSTR pSourceName, // Optional file name for pSource. Used in errors and
@@ -1854,6 +2253,15 @@ HRESULT DxcCompilerAdapter::WrapCompile(
     if (opts.TimeReport) {
       std::string TimeReport;
       raw_string_ostream OS(TimeReport);
+      // Keep the report produced by the compilation itself, if any (e.g. the
+      // SPIR-V optimizer pass timings), ahead of the LLVM timers.
+      CComPtr<IDxcBlobUtf8> pCompileTimeReport;
+      if (SUCCEEDED(pImplResult->GetOutput(DXC_OUT_TIME_REPORT,
+                                           IID_PPV_ARGS(&pCompileTimeReport),
+                                           nullptr)) &&
+          pCompileTimeReport)
+        OS << StringRef(pCompileTimeReport->GetStringPointer(),
+                        pCompileTimeReport->GetStringLength());
       llvm::TimerGroup::printAll(OS);
       IFT(pResult->SetOutputString(DXC_OUT_TIME_REPORT, TimeReport.c_str(),
                                    TimeReport.size()));
@@ -272,7 +272,7 @@ public:
   }
 };
 
-struct DxcPdbUtils : public IDxcPdbUtils2
+struct DxcPdbUtils : public IDxcPdbUtils3
 #ifdef _WIN32
     // Skip Pix debug info on linux for dia dependence.
     ,
@@ -312,6 +312,10 @@ private:
   // necessarily change across different PDBs.
   CComPtr<IDxcCompiler3> m_pCompiler;
 
+  // Directory supplied by the host through SetSourceStore. Like m_pCompiler,
+  // it is kept across Reset().
+  std::string m_SourceStore;
+
   struct ArgPair {
     CComPtr<IDxcBlobWide> Name;
     CComPtr<IDxcBlobWide> Value;
@@ -431,6 +435,21 @@ private:
     return S_OK;
   }
 
+  // Resolves a source that was written with -Qsource_store against the store
+  // directory set by the host. Without a store, or if the source cannot be
+  // read from it or no longer matches its key, the source is kept with empty
+  // content so the rest of the PDB is still usable.
+  HRESULT AddSourceFromStore(StringRef name, StringRef key) {
+    CComPtr<IDxcBlobEncoding> pContent;
+    if (m_SourceStore.empty() ||
+        FAILED(hlsl::ReadSourceFromStore(m_pMalloc, m_SourceStore, key,
+                                         &pContent)))
+      return AddSource(name, StringRef());
+    return AddSource(name,
+                     StringRef((const char *)pContent->GetBufferPointer(),
+                               pContent->GetBufferSize()));
+  }
+
   HRESULT LoadFromPDBInfoPart(const hlsl::DxilShaderPDBInfo *header,
                               uint32_t partSize) {
     if (header->Version > hlsl::DxilShaderPDBInfoVersion::Latest) {
@@ -716,7 +735,12 @@ private:
 
         // Sources
         for (unsigned i = 0; i < reader.GetSourcesCount(); i++) {
-          hlsl::SourceInfoReader::Source source_data = reader.GetSource(i);
+          const hlsl::SourceInfoReader::Source &source_data =
+              reader.GetSource(i);
+          if (!source_data.StoreKey.empty()) {
+            IFR(AddSourceFromStore(source_data.Name, source_data.StoreKey));
+            continue;
+          }
           IFR(AddSource(source_data.Name, source_data.Content));
         }
 
@@ -845,10 +869,12 @@ public:
                                            void **ppvObject) override {
 #ifdef _WIN32
     HRESULT hr =
-        DoBasicQueryInterface<IDxcPdbUtils2, IDxcPixDxilDebugInfoFactory>(
-            this, iid, ppvObject);
+        DoBasicQueryInterface<IDxcPdbUtils3, IDxcPdbUtils2,
+                              IDxcPixDxilDebugInfoFactory>(this, iid,
+                                                           ppvObject);
 #else
-    HRESULT hr = DoBasicQueryInterface<IDxcPdbUtils2>(this, iid, ppvObject);
+    HRESULT hr = DoBasicQueryInterface<IDxcPdbUtils3, IDxcPdbUtils2>(
+        this, iid, ppvObject);
 #endif
     if (FAILED(hr)) {
       return DoBasicQueryInterface<IDxcPdbUtils>(&m_Adapter, iid, ppvObject);
@@ -1033,6 +1059,19 @@ public:
            !m_WholeDxil;
   }
 
+  virtual HRESULT STDMETHODCALLTYPE
+  SetSourceStore(LPCWSTR pStoreDirectory) override {
+    if (!pStoreDirectory) {
+      m_SourceStore.clear();
+      return S_OK;
+    }
+    std::string storeDir;
+    if (!Unicode::WideToUTF8String(pStoreDirectory, &storeDir))
+      return E_INVALIDARG;
+    m_SourceStore = std::move(storeDir);
+    return S_OK;
+  }
+
   HRESULT SetEntryPointToDefaultIfEmpty() {
     // Entry point might have been omitted. Set it to main by default.
     // Don't set entry point if this instance is non-debug DXIL and has no
@@ -1152,6 +1191,7 @@ public:
     auto reader = rdat.GetDxilPdbInfoTable()[0];
 
     CComPtr<DxcPdbUtils> pNewPdbUtils = DxcPdbUtils::Alloc(m_pMalloc);
+    pNewPdbUtils->m_SourceStore = m_SourceStore;
     IFR(pNewPdbUtils->LoadFromPdbInfoReader(reader));
     pNewPdbUtils.QueryInterface(ppOutPdbUtils);
 
@@ -15,6 +15,7 @@
 #include "dxc/DxilContainer/DxilContainer.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Frontend/CodeGenOptions.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/Path.h"
 
 #include "dxc/Support/Global.h"
@@ -25,212 +26,6 @@
 using namespace hlsl;
 using Buffer = SourceInfoWriter::Buffer;
 
-///////////////////////////////////////////////////////////////////////////////
-// Reader
-///////////////////////////////////////////////////////////////////////////////
-
-static size_t PointerByteOffset(const void *a, const void *b) {
-  return (const uint8_t *)a - (const uint8_t *)b;
-}
-
-bool SourceInfoReader::Init(const hlsl::DxilSourceInfo *SourceInfo,
-                            unsigned sourceInfoSize) {
-  if (sizeof(*SourceInfo) > sourceInfoSize)
-    return false;
-  if (SourceInfo->AlignedSizeInBytes > sourceInfoSize)
-    return false;
-
-  const hlsl::DxilSourceInfo *mainHeader = SourceInfo;
-  const size_t totalSizeInBytes = mainHeader->AlignedSizeInBytes;
-
-  const hlsl::DxilSourceInfoSection *section =
-      (const hlsl::DxilSourceInfoSection *)(SourceInfo + 1);
-  for (unsigned i = 0; i < SourceInfo->SectionCount; i++) {
-
-    if (PointerByteOffset(section + 1, mainHeader) > totalSizeInBytes)
-      return false;
-    if (PointerByteOffset(section, mainHeader) + section->AlignedSizeInBytes >
-        totalSizeInBytes)
-      return false;
-
-    const size_t sectionSizeInBytes = section->AlignedSizeInBytes;
-
-    switch (section->Type) {
-    case hlsl::DxilSourceInfoSectionType::Args: {
-      const hlsl::DxilSourceInfo_Args *header =
-          (const hlsl::DxilSourceInfo_Args *)(section + 1);
-
-      if (PointerByteOffset(header + 1, section) > sectionSizeInBytes)
-        return false;
-      if (PointerByteOffset(header + 1, section) + header->SizeInBytes >
-          sectionSizeInBytes)
-        return false;
-
-      const char *ptr = (const char *)(header + 1);
-      unsigned i = 0;
-      while (i < header->SizeInBytes) {
-
-        // To learn more about the format of this data, check struct
-        // DxilSourceInfo_Args in DxilContainer.h Read the argument name
-        const char *argName = ptr + i;
-        unsigned argNameLength = 0;
-        for (; i < header->SizeInBytes; i++) {
-          if (ptr[i] == '\0') {
-            i++;
-            break;
-          }
-          argNameLength++;
-        }
-
-        // Read the argument value
-        const char *argValue = ptr + i;
-        unsigned argValueLength = 0;
-        for (; i < header->SizeInBytes; i++) {
-          if (ptr[i] == '\0') {
-            i++;
-            break;
-          }
-          argValueLength++;
-        }
-
-        ArgPair pair = {};
-        assert(argNameLength || argValueLength);
-        if (argNameLength || argValueLength) {
-          if (argNameLength)
-            pair.Name.assign(argName, argNameLength);
-          if (argValueLength)
-            pair.Value.assign(argValue, argValueLength);
-          m_ArgPairs.push_back(std::move(pair));
-        }
-      }
-    } break;
-
-    case hlsl::DxilSourceInfoSectionType::SourceNames: {
-      const hlsl::DxilSourceInfo_SourceNames *header =
-          (const hlsl::DxilSourceInfo_SourceNames *)(section + 1);
-      if (PointerByteOffset(header + 1, section) > sectionSizeInBytes)
-        return false;
-      if (PointerByteOffset(header + 1, section) + header->EntriesSizeInBytes >
-          sectionSizeInBytes)
-        return false;
-
-      assert(m_Sources.size() == 0 || m_Sources.size() == header->Count);
-      m_Sources.resize(header->Count);
-
-      const hlsl::DxilSourceInfo_SourceNamesEntry *firstEntry =
-          (const hlsl::DxilSourceInfo_SourceNamesEntry *)(header + 1);
-      const hlsl::DxilSourceInfo_SourceNamesEntry *entry = firstEntry;
-
-      for (unsigned i = 0; i < header->Count; i++) {
-        if (PointerByteOffset(entry + 1, firstEntry) >
-            header->EntriesSizeInBytes)
-          return false;
-        if (PointerByteOffset(entry + 1, firstEntry) + entry->NameSizeInBytes >
-            header->EntriesSizeInBytes)
-          return false;
-        if (PointerByteOffset(entry, firstEntry) + entry->AlignedSizeInBytes >
-            header->EntriesSizeInBytes)
-          return false;
-
-        const void *ptr = entry + 1;
-        if (entry->NameSizeInBytes > 0) {
-          // Fail if not null terminated
-          if (((const char *)ptr)[entry->NameSizeInBytes - 1] != '\0')
-            return false;
-          llvm::StringRef name = {
-              (const char *)ptr,
-              entry->NameSizeInBytes - 1,
-          };
-          m_Sources[i].Name = name;
-        }
-
-        entry = (const hlsl::DxilSourceInfo_SourceNamesEntry
-                     *)((const uint8_t *)entry + entry->AlignedSizeInBytes);
-      }
-
-    } break;
-    case hlsl::DxilSourceInfoSectionType::SourceContents: {
-      const hlsl::DxilSourceInfo_SourceContents *header =
-          (const hlsl::DxilSourceInfo_SourceContents *)(section + 1);
-      if (PointerByteOffset(header + 1, section) > sectionSizeInBytes)
-        return false;
-      if (PointerByteOffset(header + 1, section) + header->EntriesSizeInBytes >
-          sectionSizeInBytes)
-        return false;
-
-      const hlsl::DxilSourceInfo_SourceContentsEntry *firstEntry = nullptr;
-      if (header->CompressType ==
-          hlsl::DxilSourceInfo_SourceContentsCompressType::Zlib) {
-        m_UncompressedSources.resize(header->UncompressedEntriesSizeInBytes);
-        {
-          bool bDecompressSucc =
-              hlsl::ZlibResult::Success ==
-              ZlibDecompress(DxcGetThreadMallocNoRef(), header + 1,
-                             header->EntriesSizeInBytes,
-                             m_UncompressedSources.data(),
-                             m_UncompressedSources.size());
-          assert(bDecompressSucc);
-          if (!bDecompressSucc)
-            return false;
-        }
-        if (m_UncompressedSources.size() !=
-            header->UncompressedEntriesSizeInBytes)
-          return false;
-        firstEntry = (const hlsl::DxilSourceInfo_SourceContentsEntry *)
-                         m_UncompressedSources.data();
-      } else {
-        if (header->EntriesSizeInBytes !=
-            header->UncompressedEntriesSizeInBytes)
-          return false;
-        if (PointerByteOffset(header + 1, section) +
-                header->UncompressedEntriesSizeInBytes >
-            sectionSizeInBytes)
-          return false;
-        firstEntry =
-            (const hlsl::DxilSourceInfo_SourceContentsEntry *)(header + 1);
-      }
-
-      assert(m_Sources.size() == 0 || m_Sources.size() == header->Count);
-      m_Sources.resize(header->Count);
-
-      const hlsl::DxilSourceInfo_SourceContentsEntry *entry = firstEntry;
-      for (unsigned i = 0; i < header->Count; i++) {
-        if (PointerByteOffset(entry + 1, firstEntry) >
-            header->UncompressedEntriesSizeInBytes)
-          return false;
-        if (PointerByteOffset(entry + 1, firstEntry) +
-                entry->ContentSizeInBytes >
-            header->UncompressedEntriesSizeInBytes)
-          return false;
-        if (PointerByteOffset(entry, firstEntry) + entry->AlignedSizeInBytes >
-            header->UncompressedEntriesSizeInBytes)
-          return false;
-
-        const void *ptr = entry + 1;
-        if (entry->ContentSizeInBytes > 0) {
-          // Fail if not null terminated
-          if (((const char *)ptr)[entry->ContentSizeInBytes - 1] != '\0')
-            return false;
-          llvm::StringRef content = {
-              (const char *)ptr,
-              entry->ContentSizeInBytes - 1,
-          };
-          m_Sources[i].Content = content;
-        }
-
-        entry = (const hlsl::DxilSourceInfo_SourceContentsEntry
-                     *)((const uint8_t *)entry + entry->AlignedSizeInBytes);
-      }
-    } break;
-    }
-    section =
-        (const hlsl::DxilSourceInfoSection *)((const uint8_t *)section +
-                                              section->AlignedSizeInBytes);
-  }
-
-  return true;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 // Writer
 ///////////////////////////////////////////////////////////////////////////////
@@ -341,11 +136,22 @@ static std::vector<SourceFile> ComputeFileList(clang::CodeGenOptions &cgOpts,
   return ret;
 }
 
+void SourceInfoWriter::SetCompression(llvm::StringRef compression) {
+  m_CompressContents = !compression.equals_lower("none");
+  if (compression.equals_lower("fast"))
+    m_CompressionLevel = ZlibCompressionLevel::Fast;
+  else if (compression.equals_lower("best"))
+    m_CompressionLevel = ZlibCompressionLevel::Best;
+  else
+    m_CompressionLevel = ZlibCompressionLevel::Default;
+}
+
 void SourceInfoWriter::Write(llvm::StringRef targetProfile,
                              llvm::StringRef entryPoint,
                              clang::CodeGenOptions &cgOpts,
                              clang::SourceManager &srcMgr) {
   m_Buffer.clear();
+  m_StoredSources.clear();
 
   // Write an empty header first.
   hlsl::DxilSourceInfo mainHeader = {};
@@ -398,9 +204,37 @@ void SourceInfoWriter::Write(llvm::StringRef targetProfile,
   }
 
   ////////////////////////////////////////////////////////////////////
-  // Add all file contents in a list.
+  // Add all file contents in a list, or only their hashes with
+  // -Qsource_store.
   ////////////////////////////////////////////////////////////////////
-  {
+  if (m_UseSourceStore) {
+    const size_t sectionOffset = BeginSection(&m_Buffer);
+
+    hlsl::DxilSourceInfo_SourceStoreKeys header = {};
+    header.Version =
+        (uint32_t)hlsl::DxilSourceInfo_SourceStoreKeysVersion::Latest;
+    header.Count = sourceFileList.size();
+    Append(&m_Buffer, &header, sizeof(header));
+
+    // Only write the content hash, the host puts the content itself in the
+    // store under that name.
+    for (unsigned i = 0; i < sourceFileList.size(); i++) {
+      SourceFile &file = sourceFileList[i];
+      llvm::MD5 hash;
+      hash.update(file.Content);
+      llvm::MD5::MD5Result result;
+      hash.final(result);
+      Append(&m_Buffer, result, sizeof(result));
+
+      llvm::SmallString<32> key;
+      llvm::MD5::stringifyResult(result, key);
+      m_StoredSources.push_back({key.str(), file.Content});
+    }
+
+    FinishSection(&m_Buffer, sectionOffset,
+                  hlsl::DxilSourceInfoSectionType::SourceStoreKeys);
+    mainHeader.SectionCount++;
+  } else {
     const size_t sectionOffset = BeginSection(&m_Buffer);
 
     // Put all the contents in a buffer
@@ -421,9 +255,12 @@ void SourceInfoWriter::Write(llvm::StringRef targetProfile,
 
     const size_t sizeBeforeCompress = m_Buffer.size();
     bool bCompressed =
+        m_CompressContents &&
         hlsl::ZlibResult::Success ==
-        ZlibCompressAppend(DxcGetThreadMallocNoRef(), uncompressedBuffer.data(),
-                           uncompressedBuffer.size(), m_Buffer);
+            ZlibCompressAppend(DxcGetThreadMallocNoRef(),
+                               uncompressedBuffer.data(),
+                               uncompressedBuffer.size(), m_Buffer,
+                               m_CompressionLevel);
 
     // If we compressed the content, go back to rewrite the header to write the
     // correct size in bytes.
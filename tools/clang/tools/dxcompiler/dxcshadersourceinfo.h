@@ -10,9 +10,12 @@
 //                                                                           //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include "dxc/DxilCompression/DxilCompression.h"
 #include "dxc/DxilContainer/DxilContainer.h"
+#include "dxc/DxilPdbInfo/DxilSourceInfoReader.h"
 #include "llvm/ADT/StringRef.h"
 #include <stdint.h>
+#include <string>
 #include <vector>
 
 namespace clang {
@@ -22,39 +25,28 @@ class SourceManager;
 
 namespace hlsl {
 
-// TODO: Move this type to its own library.
-struct SourceInfoReader {
-  using Buffer = std::vector<uint8_t>;
-  Buffer m_UncompressedSources;
-
-  struct Source {
-    llvm::StringRef Name;
-    llvm::StringRef Content;
-  };
-
-  struct ArgPair {
-    std::string Name;
-    std::string Value;
-  };
-
-  std::vector<Source> m_Sources;
-  std::vector<ArgPair> m_ArgPairs;
-
-  Source GetSource(unsigned i) const { return m_Sources[i]; }
-  unsigned GetSourcesCount() const { return m_Sources.size(); }
-
-  const ArgPair &GetArgPair(unsigned i) const { return m_ArgPairs[i]; }
-  unsigned GetArgPairCount() const { return m_ArgPairs.size(); }
-
-  // Note: The memory for SourceInfo must outlive this structure.
-  bool Init(const hlsl::DxilSourceInfo *SourceInfo, unsigned sourceInfoSize);
-};
-
 // Herper for writing the shader source part.
 struct SourceInfoWriter {
   using Buffer = std::vector<uint8_t>;
   Buffer m_Buffer;
 
+  // How source contents are stored, see -Qsource_compression.
+  bool m_CompressContents = true;
+  ZlibCompressionLevel m_CompressionLevel = ZlibCompressionLevel::Default;
+
+  // Sources referenced by key instead of being embedded, see -Qsource_store.
+  // The host is responsible for writing them to the store.
+  struct StoredSource {
+    std::string Key;
+    llvm::StringRef Content;
+  };
+  bool m_UseSourceStore = false;
+  std::vector<StoredSource> m_StoredSources;
+
+  void SetCompression(llvm::StringRef compression);
+  void SetUseSourceStore(bool useSourceStore) {
+    m_UseSourceStore = useSourceStore;
+  }
   const hlsl::DxilSourceInfo *GetPart() const;
   void Write(llvm::StringRef targetProfile, llvm::StringRef entryPoint,
              clang::CodeGenOptions &cgOpts, clang::SourceManager &srcMgr);
@@ -88,6 +88,8 @@ static HRESULT ReadStdin(std::string &input) {
     return HRESULT_FROM_WIN32(lastError);
 }
 
+// Files are mapped rather than copied, so they must not be written while the
+// blob is alive.
 static void BlobFromFile(LPCWSTR pFileName, IDxcBlob **ppBlob) {
   CComPtr<IDxcLibrary> pLibrary;
   CComPtr<IDxcBlobEncoding> pFileBlob;
@@ -99,7 +101,7 @@ static void BlobFromFile(LPCWSTR pFileName, IDxcBlob **ppBlob) {
     IFT(pLibrary->CreateBlobWithEncodingOnHeapCopy(
         input.data(), (UINT32)input.size(), CP_UTF8, &pFileBlob))
   } else {
-    IFT(pLibrary->CreateBlobFromFile(pFileName, nullptr, &pFileBlob));
+    dxc::MapFileIntoBlob(pFileName, &pFileBlob);
   }
   *ppBlob = pFileBlob.Detach();
 }
@@ -344,6 +346,8 @@ int main(int argc, const char **argv) {
       ReadFileOpts(passFileName, &pPassOpts, passes, &optArgs, &optArgCount);
       IFT(pOptimizer->RunOptimizer(pBlob, optArgs, optArgCount, &pOutputModule,
                                    &pOutputText));
+      // Unmap the input first, the output may overwrite it.
+      pBlob.Release();
       PrintOptOutput(outFileName, pOutputModule, pOutputText);
       break;
     }
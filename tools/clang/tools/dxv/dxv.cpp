@@ -53,7 +53,7 @@ public:
 void DxvContext::Validate() {
   {
     CComPtr<IDxcBlobEncoding> pSource;
-    ReadFileIntoBlob(m_dxcSupport, StringRefWide(InputFilename), &pSource);
+    MapFileIntoBlob(StringRefWide(InputFilename), &pSource);
 
     bool bSourceIsDxilContainer = hlsl::IsValidDxilContainer(
         hlsl::IsDxilContainerLike(pSource->GetBufferPointer(),
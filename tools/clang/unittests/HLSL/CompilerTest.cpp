@@ -149,6 +149,7 @@ public:
 
   TEST_METHOD(CompileWhenDefinesThenApplied)
   TEST_METHOD(CompileWhenDefinesManyThenApplied)
+  TEST_METHOD(CompilePermutationsWhenDefinesThenApplied)
   TEST_METHOD(CompileWhenEmptyThenFails)
   TEST_METHOD(CompileWhenIncorrectThenFails)
   TEST_METHOD(CompileWhenWorksThenDisassembleWorks)
@@ -807,6 +808,89 @@ TEST_F(CompilerTest, CompileWhenDefinesManyThenApplied) {
   VERIFY_SUCCEEDED(compileStatus);
 }
 
+TEST_F(CompilerTest, CompilePermutationsWhenDefinesThenApplied) {
+  std::string main_source = R"x(
+      #include "helper.h"
+      #if VAL == 3
+      #error VAL must not be 3
+      #endif
+      float4 main() : SV_Target { return HELPER(VAL); }
+  )x";
+
+  CComPtr<IDxcCompiler4> pCompiler;
+  VERIFY_SUCCEEDED(m_dllSupport.CreateInstance(CLSID_DxcCompiler, &pCompiler));
+
+  DxcBuffer SourceBuf = {};
+  SourceBuf.Ptr = main_source.c_str();
+  SourceBuf.Size = main_source.size();
+  SourceBuf.Encoding = CP_UTF8;
+
+  LPCWSTR args[] = {L"/Tps_6_0", L"/Emain"};
+
+  CComPtr<TestIncludeHandler> pInclude;
+  pInclude = new TestIncludeHandler(m_dllSupport);
+  pInclude->CallResults.emplace_back("#define HELPER(x) (float4)(x)");
+
+  DxcDefine val1[] = {{L"VAL", L"1"}};
+  DxcDefine val2[] = {{L"VAL", L"2"}};
+  DxcDefine val1Unused[] = {{L"VAL", L"1"}, {L"UNUSED", nullptr}};
+  DxcDefine val3[] = {{L"VAL", L"3"}};
+  DxcDefineSet permutations[] = {{val1, _countof(val1)},
+                                 {val2, _countof(val2)},
+                                 {val1Unused, _countof(val1Unused)},
+                                 {val3, _countof(val3)}};
+
+  IDxcResult *results[_countof(permutations)];
+  VERIFY_SUCCEEDED(pCompiler->CompilePermutations(
+      &SourceBuf, args, _countof(args), permutations, _countof(permutations),
+      DxcCompilePermutationsFlags_Deduplicate, pInclude, results));
+  std::vector<CComPtr<IDxcResult>> pResults(results,
+                                            results + _countof(permutations));
+  for (IDxcResult *pResult : results)
+    pResult->Release();
+
+  // The include file is loaded once for all permutations.
+  VERIFY_ARE_EQUAL(1u, pInclude->CallInfos.size());
+
+  HRESULT status;
+  for (unsigned i = 0; i < 3; ++i) {
+    VERIFY_SUCCEEDED(pResults[i]->GetStatus(&status));
+    VERIFY_SUCCEEDED(status);
+  }
+  VERIFY_SUCCEEDED(pResults[3]->GetStatus(&status));
+  VERIFY_FAILED(status);
+
+  // A permutation that preprocesses to the same source shares the result.
+  VERIFY_ARE_EQUAL(pResults[0].p, pResults[2].p);
+  VERIFY_ARE_NOT_EQUAL(pResults[0].p, pResults[1].p);
+
+  // Without the flag, or with debug info that records the defines of each
+  // permutation, every permutation is compiled.
+  LPCWSTR debugArgs[] = {L"/Tps_6_0", L"/Emain", L"/Zi", L"/Qembed_debug"};
+  struct {
+    LPCWSTR *pArgs;
+    UINT32 argCount;
+    UINT32 flags;
+  } noDedupCases[] = {
+      {args, _countof(args), DxcCompilePermutationsFlags_None},
+      {debugArgs, _countof(debugArgs), DxcCompilePermutationsFlags_Deduplicate},
+  };
+  for (const auto &noDedup : noDedupCases) {
+    pInclude->CallResults.emplace_back("#define HELPER(x) (float4)(x)");
+    VERIFY_SUCCEEDED(pCompiler->CompilePermutations(
+        &SourceBuf, noDedup.pArgs, noDedup.argCount, permutations, 3,
+        noDedup.flags, pInclude, results));
+    std::vector<CComPtr<IDxcResult>> pNoDedupResults(results, results + 3);
+    for (unsigned i = 0; i < 3; ++i)
+      results[i]->Release();
+    for (unsigned i = 0; i < 3; ++i) {
+      VERIFY_SUCCEEDED(pNoDedupResults[i]->GetStatus(&status));
+      VERIFY_SUCCEEDED(status);
+    }
+    VERIFY_ARE_NOT_EQUAL(pNoDedupResults[0].p, pNoDedupResults[2].p);
+  }
+}
+
 TEST_F(CompilerTest, CompileWhenEmptyThenFails) {
   CComPtr<IDxcCompiler> pCompiler;
   CComPtr<IDxcOperationResult> pResult;
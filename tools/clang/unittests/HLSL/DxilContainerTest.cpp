@@ -44,20 +44,25 @@
 #endif
 #endif
 
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/MSFileSystem.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include "dxc/Test/HLSLTestData.h"
 #include "dxc/Test/HlslTestUtils.h"
 #include "dxc/Test/DxcTestUtils.h"
 
+#include "dxc/Support/FileIOHelper.h"
 #include "dxc/Support/Global.h"
 #include "dxc/Support/dxcapi.use.h"
 #include "dxc/Support/HLSLOptions.h"
+#include "dxc/Support/Unicode.h"
 #include "dxc/DxilContainer/DxilContainer.h"
 #include "dxc/DxilContainer/DxilRuntimeReflection.h"
 #include <assert.h> // Needed for DxilPipelineStateValidation.h
 #include "dxc/DxilContainer/DxilPipelineStateValidation.h"
+#include "dxc/DxilContainer/DxilReflectionDatabase.h"
 #include "dxc/DXIL/DxilShaderFlags.h"
 #include "dxc/DXIL/DxilUtil.h"
 
@@ -105,6 +110,9 @@ public:
   TEST_METHOD(CompileWhenOkThenCheckRDAT2)
   TEST_METHOD(CompileWhenOkThenCheckReflection1)
   TEST_METHOD(DxcUtils_CreateReflection)
+  TEST_METHOD(DxcUtils_CreateReflectionDatabase)
+  TEST_METHOD(MappedBlobWhenReleasedAfterLoadThenOK)
+  TEST_METHOD(DxcUtils_LoadFileWithFlags)
   TEST_METHOD(CheckReflectionQueryInterface)
   TEST_METHOD(CompileWhenOKThenIncludesFeatureInfo)
   TEST_METHOD(CompileWhenOKThenIncludesSignatures)
@@ -1546,6 +1554,12 @@ TEST_F(DxilContainerTest, CompileWhenOkThenCheckRDAT) {
           uint64_t rawFlag = flag.GetFeatureInfo();
           VERIFY_ARE_EQUAL(funcReader.GetFeatureFlags(), rawFlag);
           VERIFY_ARE_EQUAL(funcReader.getResources().Count(), 3U);
+          unsigned numRes = 0;
+          for (auto resReader : funcReader.getResources()) {
+            VERIFY_IS_TRUE(resReader);
+            ++numRes;
+          }
+          VERIFY_ARE_EQUAL(numRes, 3U);
         } else if (cur_str.compare("function2") == 0) {
           VERIFY_ARE_EQUAL(funcReader.GetFeatureFlags() & 0xffffffffffffffff,
                            0U);
@@ -1576,6 +1590,12 @@ TEST_F(DxilContainerTest, CompileWhenOkThenCheckRDAT) {
         }
       }
       VERIFY_ARE_EQUAL(resTable.Count(), 8U);
+      unsigned numFuncs = 0;
+      for (auto funcReader : funcTable) {
+        VERIFY_IS_TRUE(funcReader);
+        ++numFuncs;
+      }
+      VERIFY_ARE_EQUAL(numFuncs, funcTable.Count());
     }
   }
   IFTBOOLMSG(blobFound, E_FAIL, "failed to find RDAT blob after compiling");
@@ -1938,6 +1958,95 @@ TEST_F(DxilContainerTest, CompileWhenOkThenCheckReflection1) {
   IFTBOOLMSG(blobFound, E_FAIL, "failed to find RDAT blob after compiling");
 }
 
+TEST_F(DxilContainerTest, MappedBlobWhenReleasedAfterLoadThenOK) {
+  // Large enough for llvm::MemoryBuffer to map the file instead of reading it.
+  std::vector<char> data(64 * 1024);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = (char)(i * 7);
+
+#ifdef _WIN32
+  wchar_t tempDir[MAX_PATH];
+  VERIFY_WIN32_BOOL_SUCCEEDED(GetTempPathW(MAX_PATH, tempDir) != 0);
+  std::wstring fileName(tempDir);
+#else
+  const char *tempDir = std::getenv("TMPDIR");
+  std::wstring fileName = Unicode::UTF8ToWideStringOrThrow(
+      tempDir ? tempDir : "/tmp");
+  fileName += L"/";
+#endif
+  fileName += L"MappedBlobWhenReleasedAfterLoadThenOK.bin";
+  VERIFY_SUCCEEDED(
+      hlsl::WriteBinaryFile(fileName.c_str(), data.data(), (DWORD)data.size()));
+
+  CComPtr<IMalloc> pMalloc;
+  VERIFY_SUCCEEDED(DxcCoGetMalloc(1, &pMalloc));
+  CComPtr<IDxcBlobEncoding> pBlob;
+  {
+    // The per-thread file system the blob is loaded under goes away before
+    // the blob is released.
+    llvm::sys::fs::MSFileSystem *msfPtr;
+    VERIFY_SUCCEEDED(CreateMSFileSystemForDisk(&msfPtr));
+    std::unique_ptr<llvm::sys::fs::MSFileSystem> msf(msfPtr);
+    llvm::sys::fs::AutoPerThreadSystem pts(msf.get());
+    VERIFY_IS_FALSE((bool)pts.error_code());
+    VERIFY_SUCCEEDED(
+        hlsl::DxcCreateBlobFromFileMapped(pMalloc, fileName.c_str(), &pBlob));
+  }
+
+  {
+    llvm::sys::fs::AutoPerThreadSystem pts(nullptr);
+    VERIFY_ARE_EQUAL(data.size(), pBlob->GetBufferSize());
+    VERIFY_IS_TRUE(
+        0 == memcmp(data.data(), pBlob->GetBufferPointer(), data.size()));
+    pBlob.Release();
+  }
+
+  std::string narrowFileName;
+  VERIFY_IS_TRUE(Unicode::WideToUTF8String(fileName.c_str(), &narrowFileName));
+  std::remove(narrowFileName.c_str());
+}
+
+TEST_F(DxilContainerTest, DxcUtils_LoadFileWithFlags) {
+  std::vector<char> data(64 * 1024);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = (char)(i * 7);
+
+#ifdef _WIN32
+  wchar_t tempDir[MAX_PATH];
+  VERIFY_WIN32_BOOL_SUCCEEDED(GetTempPathW(MAX_PATH, tempDir) != 0);
+  std::wstring fileName(tempDir);
+#else
+  const char *tempDir = std::getenv("TMPDIR");
+  std::wstring fileName = Unicode::UTF8ToWideStringOrThrow(
+      tempDir ? tempDir : "/tmp");
+  fileName += L"/";
+#endif
+  fileName += L"DxcUtils_LoadFileWithFlags.bin";
+  VERIFY_SUCCEEDED(
+      hlsl::WriteBinaryFile(fileName.c_str(), data.data(), (DWORD)data.size()));
+
+  CComPtr<IDxcUtils2> pUtils;
+  VERIFY_SUCCEEDED(m_dllSupport.CreateInstance(CLSID_DxcUtils, &pUtils));
+
+  for (UINT32 flags : {DxcLoadFileFlags_None, DxcLoadFileFlags_Map}) {
+    CComPtr<IDxcBlobEncoding> pBlob;
+    VERIFY_SUCCEEDED(pUtils->LoadFileWithFlags(fileName.c_str(), nullptr,
+                                               flags, &pBlob));
+    VERIFY_ARE_EQUAL(data.size(), pBlob->GetBufferSize());
+    VERIFY_IS_TRUE(
+        0 == memcmp(data.data(), pBlob->GetBufferPointer(), data.size()));
+  }
+
+  CComPtr<IDxcBlobEncoding> pBlob;
+  VERIFY_ARE_EQUAL(E_INVALIDARG,
+                   pUtils->LoadFileWithFlags(fileName.c_str(), nullptr, 2,
+                                             &pBlob));
+
+  std::string narrowFileName;
+  VERIFY_IS_TRUE(Unicode::WideToUTF8String(fileName.c_str(), &narrowFileName));
+  std::remove(narrowFileName.c_str());
+}
+
 TEST_F(DxilContainerTest, DxcUtils_CreateReflection) {
   // Reflection stripping fails on DXIL.dll ver. < 1.5
   if (m_ver.SkipDxilVersion(1, 5))
@@ -2117,6 +2226,84 @@ TEST_F(DxilContainerTest, DxcUtils_CreateReflection) {
   }
 }
 
+TEST_F(DxilContainerTest, DxcUtils_CreateReflectionDatabase) {
+  CComPtr<IDxcUtils2> pUtils;
+  VERIFY_SUCCEEDED(m_dllSupport.CreateInstance(CLSID_DxcUtils, &pUtils));
+
+  const char *Shader = "cbuffer Params : register(b1) { uint g_scale; };\n"
+                       "RWStructuredBuffer<uint> g_output : register(u2);\n"
+                       "[numthreads(8, 4, 1)]\n"
+                       "void main(uint id : SV_DispatchThreadID) {\n"
+                       "  g_output[id] = id * g_scale;\n"
+                       "}";
+  CComPtr<IDxcBlob> pProgram;
+  CompileToProgram(Shader, L"main", L"cs_6_0", nullptr, 0, &pProgram);
+
+  // The second container is not a container, so only its result is recorded.
+  const char NotAContainer[] = "not a container";
+  DxcBuffer containers[3] = {};
+  containers[0].Ptr = pProgram->GetBufferPointer();
+  containers[0].Size = pProgram->GetBufferSize();
+  containers[1].Ptr = NotAContainer;
+  containers[1].Size = sizeof(NotAContainer);
+  containers[2] = containers[0];
+
+  CComPtr<IDxcBlob> pDatabase;
+  VERIFY_SUCCEEDED(pUtils->CreateReflectionDatabase(containers, 3, &pDatabase));
+  const char *pData = (const char *)pDatabase->GetBufferPointer();
+  VERIFY_IS_TRUE(pDatabase->GetBufferSize() >=
+                 sizeof(hlsl::DxilReflectionDatabaseHeader));
+  const hlsl::DxilReflectionDatabaseHeader *pHeader =
+      (const hlsl::DxilReflectionDatabaseHeader *)pData;
+  VERIFY_ARE_EQUAL(hlsl::DxilReflectionDatabaseVersion, pHeader->Version);
+  VERIFY_ARE_EQUAL((uint32_t)hlsl::DxilReflectionDatabaseTable::Count,
+                   pHeader->TableCount);
+
+  auto GetTable = [&](hlsl::DxilReflectionDatabaseTable Table) {
+    return pHeader->Tables[(uint32_t)Table];
+  };
+  hlsl::DxilReflectionDatabaseTableDesc ShaderTable =
+      GetTable(hlsl::DxilReflectionDatabaseTable::Shaders);
+  VERIFY_ARE_EQUAL(3u, ShaderTable.RecordCount);
+  VERIFY_ARE_EQUAL(sizeof(hlsl::DxilReflectionDatabaseShader),
+                   (size_t)ShaderTable.RecordSize);
+  const hlsl::DxilReflectionDatabaseShader *pShaders =
+      (const hlsl::DxilReflectionDatabaseShader *)(pData + ShaderTable.Offset);
+  VERIFY_SUCCEEDED((HRESULT)pShaders[0].Result);
+  VERIFY_FAILED((HRESULT)pShaders[1].Result);
+  VERIFY_SUCCEEDED((HRESULT)pShaders[2].Result);
+  VERIFY_ARE_EQUAL(0u, pShaders[1].ResourceCount);
+  VERIFY_ARE_EQUAL(8u, pShaders[0].ThreadGroupSize[0]);
+  VERIFY_ARE_EQUAL(4u, pShaders[0].ThreadGroupSize[1]);
+  VERIFY_ARE_EQUAL(1u, pShaders[0].ThreadGroupSize[2]);
+
+  // Both copies of the shader have their own, identical resource records.
+  VERIFY_ARE_EQUAL(2u, pShaders[0].ResourceCount);
+  VERIFY_ARE_EQUAL(pShaders[0].ResourceCount, pShaders[2].ResourceCount);
+  VERIFY_ARE_EQUAL(pShaders[0].FirstResource + pShaders[0].ResourceCount,
+                   pShaders[2].FirstResource);
+  const hlsl::DxilReflectionDatabaseResource *pResources =
+      (const hlsl::DxilReflectionDatabaseResource
+           *)(pData +
+              GetTable(hlsl::DxilReflectionDatabaseTable::Resources).Offset);
+  const char *pStrings =
+      pData + GetTable(hlsl::DxilReflectionDatabaseTable::StringBuffer).Offset;
+  std::unordered_set<std::string> Names;
+  for (uint32_t i = 0; i < pShaders[2].ResourceCount; ++i) {
+    const hlsl::DxilReflectionDatabaseResource &Res =
+        pResources[pShaders[2].FirstResource + i];
+    Names.insert(pStrings + Res.Name);
+    if (Res.Type == D3D_SIT_CBUFFER)
+      VERIFY_ARE_EQUAL(1u, Res.BindPoint);
+    else
+      VERIFY_ARE_EQUAL(2u, Res.BindPoint);
+  }
+  VERIFY_IS_TRUE(Names.count("Params") == 1);
+  VERIFY_IS_TRUE(Names.count("g_output") == 1);
+
+  VERIFY_ARE_EQUAL(1u, pShaders[0].ConstantBufferCount);
+}
+
 TEST_F(DxilContainerTest, CheckReflectionQueryInterface) {
   // Minimum version 1.3 required for library support.
   if (m_ver.SkipDxilVersion(1, 3))
@@ -15,6 +15,7 @@
 #include <array>
 
 #include "dxc/DxilContainer/DxilContainer.h"
+#include "dxc/Support/FileIOHelper.h"
 #include "dxc/Support/WinIncludes.h"
 
 #include "dxc/Test/DxcTestUtils.h"
@@ -159,6 +160,7 @@ public:
   TEST_METHOD(DxcPixDxilDebugInfo_InstructionOffsets)
 
   TEST_METHOD(PixDebugCompileInfo)
+  TEST_METHOD(PixDebugCompileInfo_SourceStore)
 
   TEST_METHOD(SymbolManager_Embedded2DArray)
 
@@ -1522,6 +1524,81 @@ TEST_F(PixDiaTest, PixDebugCompileInfo) {
   VERIFY_ARE_EQUAL(std::wstring(profile), std::wstring(hlslTarget));
 }
 
+TEST_F(PixDiaTest, PixDebugCompileInfo_SourceStore) {
+  static const char source[] = R"(
+    float4 main(float4 color : COLOR) : SV_Target {
+      return color * 2;
+    }
+  )";
+
+  wchar_t tempDir[MAX_PATH];
+  VERIFY_WIN32_BOOL_SUCCEEDED(GetTempPathW(MAX_PATH, tempDir) != 0);
+  std::wstring storeDir(tempDir);
+  storeDir += L"PixDebugCompileInfo_SourceStore";
+  CreateDirectoryW(storeDir.c_str(), nullptr);
+
+  CComPtr<IDxcCompiler3> pCompiler;
+  VERIFY_SUCCEEDED(m_dllSupport.CreateInstance(CLSID_DxcCompiler, &pCompiler));
+  LPCWSTR args[] = {L"source.hlsl", L"-T", L"ps_6_0", L"/Zi",
+                    L"/Qsource_store", storeDir.c_str()};
+  DxcBuffer buffer = {source, sizeof(source) - 1, DXC_CP_UTF8};
+  CComPtr<IDxcResult> pResult;
+  VERIFY_SUCCEEDED(pCompiler->Compile(&buffer, args, _countof(args), nullptr,
+                                      IID_PPV_ARGS(&pResult)));
+  HRESULT status;
+  VERIFY_SUCCEEDED(pResult->GetStatus(&status));
+  VERIFY_SUCCEEDED(status);
+
+  // Put the sources in the store, as dxc does.
+  CComPtr<IDxcExtraOutputs> pExtraOutputs;
+  VERIFY_SUCCEEDED(pResult->GetOutput(DXC_OUT_EXTRA_OUTPUTS,
+                                      IID_PPV_ARGS(&pExtraOutputs), nullptr));
+  VERIFY_IS_TRUE(pExtraOutputs->GetOutputCount() > 0);
+  for (UINT32 i = 0; i < pExtraOutputs->GetOutputCount(); i++) {
+    CComPtr<IDxcBlob> pStoredSource;
+    CComPtr<IDxcBlobWide> pName;
+    VERIFY_SUCCEEDED(pExtraOutputs->GetOutput(
+        i, IID_PPV_ARGS(&pStoredSource), nullptr, &pName));
+    VERIFY_SUCCEEDED(hlsl::WriteBinaryFile(
+        pName->GetStringPointer(), pStoredSource->GetBufferPointer(),
+        (DWORD)pStoredSource->GetBufferSize()));
+  }
+
+  CComPtr<IDxcBlob> pPdb;
+  VERIFY_SUCCEEDED(
+      pResult->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(&pPdb), nullptr));
+  CComPtr<IDxcLibrary> pLib;
+  VERIFY_SUCCEEDED(m_dllSupport.CreateInstance(CLSID_DxcLibrary, &pLib));
+  CComPtr<IStream> pStream;
+  VERIFY_SUCCEEDED(pLib->CreateStreamFromBlobReadOnly(pPdb, &pStream));
+
+  CComPtr<IDiaDataSource> pDiaDataSource;
+  VERIFY_SUCCEEDED(
+      m_dllSupport.CreateInstance(CLSID_DxcDiaDataSource, &pDiaDataSource));
+  CComPtr<IDxcPixSourceStore> pSourceStore;
+  VERIFY_SUCCEEDED(pDiaDataSource.QueryInterface(&pSourceStore));
+  VERIFY_SUCCEEDED(pSourceStore->SetSourceStore(storeDir.c_str()));
+  VERIFY_SUCCEEDED(pDiaDataSource->loadDataFromIStream(pStream));
+
+  CComPtr<IDiaSession> pSession;
+  VERIFY_SUCCEEDED(pDiaDataSource->openSession(&pSession));
+  CComPtr<IDxcPixDxilDebugInfoFactory> factory;
+  VERIFY_SUCCEEDED(pSession->QueryInterface(IID_PPV_ARGS(&factory)));
+  CComPtr<IDxcPixCompilationInfo> compilationInfo;
+  VERIFY_SUCCEEDED(factory->NewDxcPixCompilationInfo(&compilationInfo));
+
+  CComBSTR sourceName;
+  CComBSTR sourceContents;
+  VERIFY_SUCCEEDED(
+      compilationInfo->GetSourceFile(0, &sourceName, &sourceContents));
+  VERIFY_IS_TRUE(nullptr != wcsstr(sourceName, L"source.hlsl"));
+  VERIFY_IS_TRUE(nullptr != wcsstr(sourceContents, L"return color * 2;"));
+
+  CComBSTR entryPointFile;
+  VERIFY_SUCCEEDED(compilationInfo->GetEntryPointFile(&entryPointFile));
+  VERIFY_IS_TRUE(nullptr != wcsstr(entryPointFile, L"source.hlsl"));
+}
+
 void PixDiaTest::CompileAndRunAnnotationAndLoadDiaSource(
     dxc::DxcDllSupport &dllSupport, const char *source, const wchar_t *profile,
     IDxcIncludeHandler *includer, IDiaDataSource **ppDataSource,
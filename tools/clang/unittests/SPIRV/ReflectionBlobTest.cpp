@@ -0,0 +1,196 @@
+//===- unittests/SPIRV/ReflectionBlobTest.cpp --- Reflection blob tests ---===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/SPIRV/ReflectionBlob.h"
+#include "spirv/unified1/spirv.hpp11"
+#include "clang/SPIRV/String.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace clang::spirv;
+using ::testing::ElementsAreArray;
+
+void addInst(spv::Op op, llvm::ArrayRef<uint32_t> operands,
+             std::vector<uint32_t> *module) {
+  module->push_back(static_cast<uint32_t>(operands.size() + 1)
+                        << spv::WordCountShift |
+                    static_cast<uint32_t>(op));
+  module->insert(module->end(), operands.begin(), operands.end());
+}
+
+std::vector<uint32_t> withString(std::vector<uint32_t> operands,
+                                 llvm::StringRef str,
+                                 llvm::ArrayRef<uint32_t> trailing = {}) {
+  const auto words = string::encodeSPIRVString(str);
+  operands.insert(operands.end(), words.begin(), words.end());
+  operands.insert(operands.end(), trailing.begin(), trailing.end());
+  return operands;
+}
+
+TEST(ReflectionBlob, RejectsNonSpirv) {
+  std::vector<uint32_t> blob;
+  EXPECT_FALSE(writeReflectionBlob({1u, 2u, 3u, 4u, 5u}, &blob));
+}
+
+TEST(ReflectionBlob, ComputeShaderWithUniformBlock) {
+  enum : uint32_t {
+    kFloat = 1,
+    kVec4,
+    kBlock,
+    kPtr,
+    kBuf,
+    kVoid,
+    kFnType,
+    kMain,
+    kBound
+  };
+
+  std::vector<uint32_t> module = {spv::MagicNumber, 0x00010000u, 0u, kBound,
+                                  0u};
+  addInst(spv::Op::OpEntryPoint,
+          withString({static_cast<uint32_t>(spv::ExecutionModel::GLCompute),
+                      kMain},
+                     "main"),
+          &module);
+  addInst(spv::Op::OpExecutionMode,
+          {kMain, static_cast<uint32_t>(spv::ExecutionMode::LocalSize), 8u, 4u,
+           1u},
+          &module);
+  addInst(spv::Op::OpName, withString({kBuf}, "buf"), &module);
+  addInst(spv::Op::OpDecorate,
+          {kBuf, static_cast<uint32_t>(spv::Decoration::DescriptorSet), 1u},
+          &module);
+  addInst(spv::Op::OpDecorate,
+          {kBuf, static_cast<uint32_t>(spv::Decoration::Binding), 2u}, &module);
+  addInst(spv::Op::OpDecorate,
+          {kBlock, static_cast<uint32_t>(spv::Decoration::Block)}, &module);
+  addInst(spv::Op::OpMemberDecorate,
+          {kBlock, 0u, static_cast<uint32_t>(spv::Decoration::Offset), 0u},
+          &module);
+  addInst(spv::Op::OpMemberDecorate,
+          {kBlock, 1u, static_cast<uint32_t>(spv::Decoration::Offset), 16u},
+          &module);
+  addInst(spv::Op::OpTypeFloat, {kFloat, 32u}, &module);
+  addInst(spv::Op::OpTypeVector, {kVec4, kFloat, 4u}, &module);
+  addInst(spv::Op::OpTypeStruct, {kBlock, kFloat, kVec4}, &module);
+  addInst(spv::Op::OpTypePointer,
+          {kPtr, static_cast<uint32_t>(spv::StorageClass::Uniform), kBlock},
+          &module);
+  addInst(spv::Op::OpVariable,
+          {kPtr, kBuf, static_cast<uint32_t>(spv::StorageClass::Uniform)},
+          &module);
+  addInst(spv::Op::OpTypeVoid, {kVoid}, &module);
+  addInst(spv::Op::OpTypeFunction, {kFnType, kVoid}, &module);
+  addInst(spv::Op::OpFunction, {kVoid, kMain, 0u, kFnType}, &module);
+
+  std::vector<uint32_t> blob;
+  ASSERT_TRUE(writeReflectionBlob(module, &blob));
+
+  const auto mainName = string::encodeSPIRVString("main");
+  const auto bufName = string::encodeSPIRVString("buf");
+  std::vector<uint32_t> expected = {kReflectionBlobMagic,
+                                    kReflectionBlobVersion, 1u, 1u};
+  // Entry point
+  expected.insert(expected.end(),
+                  {static_cast<uint32_t>(spv::ExecutionModel::GLCompute), 8u,
+                   4u, 1u, static_cast<uint32_t>(mainName.size())});
+  expected.insert(expected.end(), mainName.begin(), mainName.end());
+  expected.push_back(0u);
+  // Resource
+  expected.insert(expected.end(),
+                  {static_cast<uint32_t>(spv::StorageClass::Uniform), 1u, 2u,
+                   static_cast<uint32_t>(spv::Op::OpTypeStruct),
+                   static_cast<uint32_t>(
+                       ReflectionDescriptorKind::UniformBuffer),
+                   ~0u, 1u, 32u, 2u, 0u, 16u,
+                   static_cast<uint32_t>(bufName.size())});
+  expected.insert(expected.end(), bufName.begin(), bufName.end());
+
+  EXPECT_THAT(blob, ElementsAreArray(expected));
+}
+
+TEST(ReflectionBlob, ResolvesDescriptorKinds) {
+  enum : uint32_t {
+    kFloat = 1,
+    kStorageImage,
+    kStorageImagePtr,
+    kTexelBuffer,
+    kTexelBufferPtr,
+    kBufferBlock,
+    kBufferBlockPtr,
+    kImageVar,
+    kTexelBufferVar,
+    kBufferBlockVar,
+    kBound
+  };
+
+  std::vector<uint32_t> module = {spv::MagicNumber, 0x00010000u, 0u, kBound,
+                                  0u};
+  addInst(spv::Op::OpDecorate,
+          {kBufferBlock, static_cast<uint32_t>(spv::Decoration::BufferBlock)},
+          &module);
+  addInst(spv::Op::OpTypeFloat, {kFloat, 32u}, &module);
+  // RWTexture2D<float> and Buffer<float>.
+  addInst(spv::Op::OpTypeImage,
+          {kStorageImage, kFloat, static_cast<uint32_t>(spv::Dim::Dim2D), 2u,
+           0u, 0u, 2u, static_cast<uint32_t>(spv::ImageFormat::R32f)},
+          &module);
+  addInst(spv::Op::OpTypeImage,
+          {kTexelBuffer, kFloat, static_cast<uint32_t>(spv::Dim::Buffer), 2u,
+           0u, 0u, 1u, static_cast<uint32_t>(spv::ImageFormat::R32f)},
+          &module);
+  addInst(spv::Op::OpTypeStruct, {kBufferBlock, kFloat}, &module);
+  const uint32_t uniformConstant =
+      static_cast<uint32_t>(spv::StorageClass::UniformConstant);
+  const uint32_t uniform = static_cast<uint32_t>(spv::StorageClass::Uniform);
+  addInst(spv::Op::OpTypePointer,
+          {kStorageImagePtr, uniformConstant, kStorageImage}, &module);
+  addInst(spv::Op::OpTypePointer,
+          {kTexelBufferPtr, uniformConstant, kTexelBuffer}, &module);
+  addInst(spv::Op::OpTypePointer, {kBufferBlockPtr, uniform, kBufferBlock},
+          &module);
+  addInst(spv::Op::OpVariable, {kStorageImagePtr, kImageVar, uniformConstant},
+          &module);
+  addInst(spv::Op::OpVariable,
+          {kTexelBufferPtr, kTexelBufferVar, uniformConstant}, &module);
+  addInst(spv::Op::OpVariable, {kBufferBlockPtr, kBufferBlockVar, uniform},
+          &module);
+
+  std::vector<uint32_t> blob;
+  ASSERT_TRUE(writeReflectionBlob(module, &blob));
+
+  const auto emptyName = string::encodeSPIRVString("");
+  const uint32_t emptyNameSize = static_cast<uint32_t>(emptyName.size());
+  std::vector<uint32_t> expected = {kReflectionBlobMagic,
+                                    kReflectionBlobVersion, 0u, 3u};
+  expected.insert(
+      expected.end(),
+      {uniformConstant, ~0u, ~0u, static_cast<uint32_t>(spv::Op::OpTypeImage),
+       static_cast<uint32_t>(ReflectionDescriptorKind::StorageImage),
+       static_cast<uint32_t>(spv::Dim::Dim2D), 1u, 0u, 0u, emptyNameSize});
+  expected.insert(expected.end(), emptyName.begin(), emptyName.end());
+  expected.insert(
+      expected.end(),
+      {uniformConstant, ~0u, ~0u, static_cast<uint32_t>(spv::Op::OpTypeImage),
+       static_cast<uint32_t>(ReflectionDescriptorKind::UniformTexelBuffer),
+       static_cast<uint32_t>(spv::Dim::Buffer), 1u, 0u, 0u, emptyNameSize});
+  expected.insert(expected.end(), emptyName.begin(), emptyName.end());
+  expected.insert(
+      expected.end(),
+      {uniform, ~0u, ~0u, static_cast<uint32_t>(spv::Op::OpTypeStruct),
+       static_cast<uint32_t>(ReflectionDescriptorKind::StorageBuffer), ~0u, 1u,
+       4u, 1u, 0u, emptyNameSize});
+  expected.insert(expected.end(), emptyName.begin(), emptyName.end());
+
+  EXPECT_THAT(blob, ElementsAreArray(expected));
+}
+
+} // anonymous namespace
@@ -6371,6 +6371,12 @@ class db_dxil(object):
             [],
         )
         add_pass("red", "ReducibilityAnalysis", "Reducibility Analysis", [])
+        add_pass(
+            "dxil-control-dependence",
+            "ControlDependenceAnalysis",
+            "DXIL Control Dependence",
+            [],
+        )
         add_pass(
             "viewid-state",
             "ComputeViewIdState",